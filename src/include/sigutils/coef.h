@@ -22,6 +22,10 @@
 
 #include <sigutils/types.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
 SUFLOAT *su_dcof_bwlp(int n, SUFLOAT fcf);
 SUFLOAT *su_dcof_bwhp(int n, SUFLOAT fcf);
 SUFLOAT *su_dcof_bwbp(int n, SUFLOAT f1f, SUFLOAT f2f);
@@ -37,4 +41,13 @@ SUFLOAT su_sf_bwhp(int n, SUFLOAT fcf);
 SUFLOAT su_sf_bwbp(int n, SUFLOAT f1f, SUFLOAT f2f);
 SUFLOAT su_sf_bwbs(int n, SUFLOAT f1f, SUFLOAT f2f);
 
+/* Second-order sections (b0, b1, b2, a1, a2). Section count in count */
+SUFLOAT *su_sos_bwlp(int n, SUFLOAT fcf, unsigned int *count);
+SUFLOAT *su_sos_bwhp(int n, SUFLOAT fcf, unsigned int *count);
+SUFLOAT *su_sos_bwbp(int n, SUFLOAT f1f, SUFLOAT f2f, unsigned int *count);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
 #endif /* _SIGUTILS_COEF_H */
@@ -0,0 +1,120 @@
+/*
+
+  Copyright (C) 2026 Gonzalo José Carracedo Carballal
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, version 3.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this program.  If not, see
+  <http://www.gnu.org/licenses/>
+
+*/
+
+#ifndef _SIGUTILS_DECIM_H
+#define _SIGUTILS_DECIM_H
+
+#include <sigutils/defs.h>
+#include <sigutils/types.h>
+
+#ifdef __cplusplus
+#  ifdef __clang__
+#    pragma clang diagnostic push
+#    pragma clang diagnostic ignored "-Wreturn-type-c-linkage"
+#  endif  // __clang__
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Polyphase decimating FIR filter. Only the outputs that survive the
+ * decimation are computed: every D input samples, the taps are applied
+ * to the last L inputs at once, which is the work of the D polyphase
+ * branches of the filter running at the output rate. The cost per input
+ * sample is L / D multiply-accumulates, instead of L for the full-rate
+ * filter.
+ */
+struct sigutils_decim {
+  unsigned int decimation; /* Input samples per output sample (D) */
+  unsigned int taps;       /* Filter length (L) */
+  SUFLOAT *h;              /* Filter taps, in reverse order */
+
+  /*
+   * The last L samples are kept in a circular buffer of twice that
+   * size. Every sample is written twice (p and p + L), so that the
+   * filter history is always available at history + p, in order.
+   */
+  SUCOMPLEX *history;
+  unsigned int p;
+  unsigned int fill; /* Samples since the last output */
+};
+
+typedef struct sigutils_decim su_decim_t;
+
+#define su_decim_INITIALIZER     \
+  {                              \
+    0, 0, NULL, NULL, 0, 0       \
+  }
+
+SUINLINE
+SU_GETTER(su_decim, unsigned int, get_decimation)
+{
+  return self->decimation;
+}
+
+/* Number of outputs that feeding size samples would produce */
+SUINLINE
+SU_GETTER(su_decim, SUSCOUNT, get_output_size, SUSCOUNT size)
+{
+  return (self->fill + size) / self->decimation;
+}
+
+/* Initialize from arbitrary taps */
+SU_CONSTRUCTOR(
+    su_decim,
+    unsigned int decimation,
+    const SUFLOAT *h,
+    unsigned int taps);
+
+/*
+ * Initialize as a windowed-sinc low-pass filter of taps_per_phase * D
+ * taps, cutoff frequency fc (normalized) and unity gain at DC.
+ */
+SU_METHOD(
+    su_decim,
+    SUBOOL,
+    init_lowpass,
+    unsigned int decimation,
+    unsigned int taps_per_phase,
+    SUFLOAT fc);
+
+SU_DESTRUCTOR(su_decim);
+
+SU_METHOD(su_decim, void, reset);
+
+/*
+ * Filter and decimate size input samples. out must have room for
+ * su_decim_get_output_size(self, size) samples, which is the number of
+ * samples written to it.
+ */
+SU_METHOD(
+    su_decim,
+    SUSCOUNT,
+    feed_bulk,
+    const SUCOMPLEX *__restrict in,
+    SUSCOUNT size,
+    SUCOMPLEX *__restrict out);
+
+#ifdef __cplusplus
+#  ifdef __clang__
+#    pragma clang diagnostic pop
+#  endif  // __clang__
+}
+#endif /* __cplusplus */
+
+#endif /* _SIGUTILS_DECIM_H */
@@ -0,0 +1,79 @@
+/*
+
+  Copyright (C) 2026 Gonzalo José Carracedo Carballal
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, version 3.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this program.  If not, see
+  <http://www.gnu.org/licenses/>
+
+*/
+
+#ifndef _SIGUTILS_DESIGN_H
+#define _SIGUTILS_DESIGN_H
+
+#include <sigutils/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Filter design cache. Coefficient sets are designed once per set of
+ * design parameters and shared by every object that requests them, so
+ * that building filters does not need to recompute (or allocate) them
+ * again. The returned arrays are immutable and must be released with
+ * su_design_release. Designs that are no longer in use are kept around
+ * (up to SU_DESIGN_CACHE_MAX_IDLE of them, holding no more than
+ * SU_DESIGN_CACHE_MAX_IDLE_SIZE coefficients) for future requests.
+ */
+#define SU_DESIGN_CACHE_MAX_IDLE      64
+#define SU_DESIGN_CACHE_MAX_IDLE_SIZE 262144
+
+struct sigutils_design_cache_stats {
+  SUSCOUNT hits;    /* Designs served from the cache */
+  SUSCOUNT misses;  /* Designs that had to be computed */
+  SUSCOUNT entries; /* Designs currently in the cache */
+  SUSCOUNT idle;    /* Cached designs that are not in use */
+  SUSCOUNT size;    /* Coefficients held by the cache */
+};
+
+/* Butterworth lowpass, direct form (see su_dcof_bwlp and su_ccof_bwlp) */
+const SUFLOAT *su_design_dcof_bwlp(int n, SUFLOAT fcf);
+const SUFLOAT *su_design_ccof_bwlp(int n);
+SUFLOAT su_design_sf_bwlp(int n, SUFLOAT fcf);
+
+/* Butterworth filters as second-order sections (see su_sos_bwlp) */
+const SUFLOAT *su_design_sos_bwlp(int n, SUFLOAT fcf, unsigned int *count);
+const SUFLOAT *su_design_sos_bwhp(int n, SUFLOAT fcf, unsigned int *count);
+const SUFLOAT *su_design_sos_bwbp(
+    int n,
+    SUFLOAT f1f,
+    SUFLOAT f2f,
+    unsigned int *count);
+
+/* FIR taps (see su_taps_rrc_init and friends) */
+const SUFLOAT *su_design_rrc(SUFLOAT T, SUFLOAT beta, SUSCOUNT size);
+const SUFLOAT *su_design_brickwall_lp(SUFLOAT fc, SUSCOUNT size);
+const SUFLOAT *su_design_brickwall_bp(
+    SUFLOAT bw,
+    SUFLOAT if_nor,
+    SUSCOUNT size);
+
+void su_design_release(const SUFLOAT *coef);
+
+void su_design_get_cache_stats(struct sigutils_design_cache_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* _SIGUTILS_DESIGN_H */
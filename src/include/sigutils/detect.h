@@ -24,6 +24,7 @@
 #include <sigutils/ncqo.h>
 #include <sigutils/sigutils.h>
 #include <sigutils/softtune.h>
+#include <sigutils/window.h>
 
 
 #ifdef __cplusplus
@@ -89,12 +90,13 @@ enum sigutils_channel_detector_mode {
   SU_CHANNEL_DETECTOR_MODE_ORDER_ESTIMATION /* To find constellation size */
 };
 
+/* Same values as sigutils_window_kind */
 enum sigutils_channel_detector_window {
-  SU_CHANNEL_DETECTOR_WINDOW_NONE,             /* Rectangular window */
-  SU_CHANNEL_DETECTOR_WINDOW_HAMMING,          /* Hamming window */
-  SU_CHANNEL_DETECTOR_WINDOW_HANN,             /* Hann window */
-  SU_CHANNEL_DETECTOR_WINDOW_FLAT_TOP,         /* Flat-top window */
-  SU_CHANNEL_DETECTOR_WINDOW_BLACKMANN_HARRIS, /* Blackmann-Harris window */
+  SU_CHANNEL_DETECTOR_WINDOW_NONE = SU_WINDOW_RECTANGULAR,
+  SU_CHANNEL_DETECTOR_WINDOW_HAMMING = SU_WINDOW_HAMMING,
+  SU_CHANNEL_DETECTOR_WINDOW_HANN = SU_WINDOW_HANN,
+  SU_CHANNEL_DETECTOR_WINDOW_FLAT_TOP = SU_WINDOW_FLAT_TOP,
+  SU_CHANNEL_DETECTOR_WINDOW_BLACKMANN_HARRIS = SU_WINDOW_BLACKMANN_HARRIS,
 };
 
 struct sigutils_channel_detector_params {
@@ -166,7 +168,8 @@ struct sigutils_channel_detector {
   SUSCOUNT next_to_window;
   unsigned int iters;
   unsigned int chan_age;
-  SU_FFTW(_complex) * window_func;
+  const SU_FFTW(_complex) * window_func; /* From the window cache */
+  const SUFLOAT *nl_window; /* Blackmann-Harris, for NONLINEAR_DIFF */
   SU_FFTW(_complex) * window;
   SU_FFTW(_plan) fft_plan;
   SU_FFTW(_complex) * fft;
@@ -185,7 +188,7 @@ struct sigutils_channel_detector {
   SUFLOAT *spmin;
   SUFLOAT N0;   /* Detected noise floor */
   SUCOMPLEX dc; /* Detected DC component */
-  PTR_LIST(struct sigutils_channel, channel);
+  PTR_SLOTMAP(struct sigutils_channel, channel);
 
   /* Baudrate estimator members */
   SUFLOAT baud;          /* Detected baudrate */
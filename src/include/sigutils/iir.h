@@ -26,6 +26,17 @@
 
 #define SU_FLOAT_GUARD INFINITY
 
+/*
+ * FIR filters (no feedback) of at least SU_IIR_OLS_MIN_TAPS taps are
+ * evaluated by su_iir_filt_feed_bulk using overlap-save fast convolution,
+ * with FFTs of at least SU_IIR_OLS_FFT_RATIO times the number of taps.
+ */
+#define SU_IIR_OLS_MIN_TAPS 64
+#define SU_IIR_OLS_FFT_RATIO 4
+
+/* Samples filtered at once by the direct form in su_iir_filt_feed_bulk */
+#define SU_IIR_BLOCK_SIZE 512
+
 #ifdef __cplusplus
 #  ifdef __clang__
 #    pragma clang diagnostic push
@@ -53,26 +64,85 @@ struct sigutils_iir_filt {
   SUFLOAT *a;
   SUFLOAT *b;
 
+  /*
+   * Linear histories used by su_iir_filt_feed_bulk: the last x_size - 1
+   * inputs (y_size - 1 outputs) followed by up to SU_IIR_BLOCK_SIZE new
+   * ones, so that a whole block is filtered without wrapping pointers.
+   */
+  SUCOMPLEX *x_lin;
+  SUCOMPLEX *y_lin;
+
   SUFLOAT gain;
+
+  /*
+   * Filters designed from their poles are run as a cascade of second
+   * order sections (transposed direct form II) instead. In that case,
+   * x_size and y_size are 0 and the buffers above are not used.
+   */
+  unsigned int sos_count; /* Number of sections */
+  SUFLOAT *sos;           /* b0, b1, b2, a1, a2 of every section */
+  SUCOMPLEX *sos_state;   /* Two state variables per section */
+
+  /*
+   * Overlap-save engine of long FIR filters. The input history is still
+   * kept in x, so su_iir_filt_feed and su_iir_filt_feed_bulk can be
+   * mixed freely.
+   */
+  unsigned int ols_size;  /* FFT size (0 if disabled) */
+  unsigned int ols_block; /* New samples per FFT */
+  SUSCOUNT ols_cost;      /* Rough cost of a block, in taps */
+  SU_FFTW(_complex) * ols_h;   /* Frequency response, scaled by 1/size */
+  SU_FFTW(_complex) * ols_buf; /* Transform buffer */
+  SU_FFTW(_plan) ols_forward;
+  SU_FFTW(_plan) ols_backward;
+
+  /*
+   * Coefficients obtained from the design cache (see design.h), or NULL.
+   * They are shared with other filters, and released on finalization.
+   */
+  const SUFLOAT *design;
 };
 
 typedef struct sigutils_iir_filt su_iir_filt_t;
 
-#define su_iir_filt_INITIALIZER                    \
-  {                                                \
-    0, 0, 0, 0, 0, 0, 0, NULL, NULL, NULL, NULL, 1 \
+#define su_iir_filt_INITIALIZER                                      \
+  {                                                                  \
+    0, 0, 0, 0, 0, 0, 0, NULL, NULL, NULL, NULL, NULL, NULL, 1, 0,   \
+        NULL, NULL, 0, 0, 0, NULL, NULL, NULL, NULL, NULL            \
   }
 
 /* Push sample to filter */
 SUCOMPLEX su_iir_filt_feed(su_iir_filt_t *filt, SUCOMPLEX x);
 
-/* Push a bunch of samples to filter */
+/*
+ * Push a bunch of samples to filter. x and y may be the same buffer
+ * (in-place filtering), but must not overlap otherwise.
+ */
 void su_iir_filt_feed_bulk(
     su_iir_filt_t *filt,
-    const SUCOMPLEX *__restrict x,
-    SUCOMPLEX *__restrict y,
+    const SUCOMPLEX *x,
+    SUCOMPLEX *y,
     SUSCOUNT len);
 
+/*
+ * Same as su_iir_filt_feed_bulk, for long offline buffers. The buffer
+ * is split in up to `threads` chunks that are filtered in parallel from
+ * zero state. The response to the actual initial state of every chunk
+ * (obtained by a scan over the chunks, using the state transition matrix
+ * of the filter) is then added to each chunk, again in parallel. The
+ * result is the serial output up to rounding errors. As in
+ * su_iir_filt_feed_bulk, x and y may be the same buffer. Buffers too
+ * short to be split are filtered serially.
+ */
+#define SU_IIR_PARALLEL_MIN_CHUNK 65536
+
+SUBOOL su_iir_filt_feed_bulk_parallel(
+    su_iir_filt_t *filt,
+    const SUCOMPLEX *x,
+    SUCOMPLEX *y,
+    SUSCOUNT len,
+    unsigned int threads);
+
 /* Get last output */
 SUCOMPLEX su_iir_filt_get(const su_iir_filt_t *filt);
 
@@ -95,6 +165,19 @@ SUBOOL __su_iir_filt_init(
     SUFLOAT *__restrict b,
     SUBOOL copy_coef);
 
+/* Initialize filter as a cascade of second order sections */
+SUBOOL su_iir_filt_init_sos(
+    su_iir_filt_t *filt,
+    unsigned int count,
+    const SUFLOAT *sos);
+
+/* Initialize filter as a cascade of second order sections (internal) */
+SUBOOL __su_iir_filt_init_sos(
+    su_iir_filt_t *filt,
+    unsigned int count,
+    SUFLOAT *sos,
+    SUBOOL copy_coef);
+
 /* Set output gain */
 void su_iir_filt_set_gain(su_iir_filt_t *filt, SUFLOAT gain);
 
@@ -128,6 +211,202 @@ SUBOOL su_iir_brickwall_bp_init(
 /* Destroy filter */
 void su_iir_filt_finalize(su_iir_filt_t *filt);
 
+/*
+ * Real filters. Same as above, for real-valued streams: inputs, outputs
+ * and state are SUFLOAT, saving the arithmetic on the (null) imaginary
+ * part. Input and output histories are stored newest first in buffers
+ * of twice their size, so the direct form is a pair of contiguous dot
+ * products.
+ */
+struct sigutils_iir_rfilt {
+  unsigned int x_size;
+  unsigned int y_size;
+
+  int x_ptr;
+  int y_ptr;
+
+  SUFLOAT curr_y;
+
+  SUFLOAT *y;
+  SUFLOAT *x;
+
+  SUFLOAT *a;
+  SUFLOAT *b;
+
+  SUFLOAT gain;
+
+  unsigned int sos_count; /* Number of sections */
+  SUFLOAT *sos;           /* b0, b1, b2, a1, a2 of every section */
+  SUFLOAT *sos_state;     /* Two state variables per section */
+
+  const SUFLOAT *design;  /* Shared coefficients, as in su_iir_filt_t */
+};
+
+typedef struct sigutils_iir_rfilt su_iir_rfilt_t;
+
+#define su_iir_rfilt_INITIALIZER                                  \
+  {                                                               \
+    0, 0, 0, 0, 0, NULL, NULL, NULL, NULL, 1, 0, NULL, NULL, NULL \
+  }
+
+/* Push sample to real filter */
+SUFLOAT su_iir_rfilt_feed(su_iir_rfilt_t *filt, SUFLOAT x);
+
+/* Push a bunch of samples to real filter, possibly in place */
+void su_iir_rfilt_feed_bulk(
+    su_iir_rfilt_t *filt,
+    const SUFLOAT *x,
+    SUFLOAT *y,
+    SUSCOUNT len);
+
+/* Get last output */
+SUFLOAT su_iir_rfilt_get(const su_iir_rfilt_t *filt);
+
+void su_iir_rfilt_reset(su_iir_rfilt_t *filt);
+
+/* Initialize real filter */
+SUBOOL su_iir_rfilt_init(
+    su_iir_rfilt_t *filt,
+    SUSCOUNT y_size,
+    const SUFLOAT *__restrict a,
+    SUSCOUNT x_size,
+    const SUFLOAT *__restrict b);
+
+/* Initialize real filter (internal) */
+SUBOOL __su_iir_rfilt_init(
+    su_iir_rfilt_t *filt,
+    SUSCOUNT y_size,
+    SUFLOAT *__restrict a,
+    SUSCOUNT x_size,
+    SUFLOAT *__restrict b,
+    SUBOOL copy_coef);
+
+/* Initialize real filter as a cascade of second order sections */
+SUBOOL su_iir_rfilt_init_sos(
+    su_iir_rfilt_t *filt,
+    unsigned int count,
+    const SUFLOAT *sos);
+
+/* Initialize real filter as a cascade of second order sections (internal) */
+SUBOOL __su_iir_rfilt_init_sos(
+    su_iir_rfilt_t *filt,
+    unsigned int count,
+    SUFLOAT *sos,
+    SUBOOL copy_coef);
+
+/* Set output gain */
+void su_iir_rfilt_set_gain(su_iir_rfilt_t *filt, SUFLOAT gain);
+
+/* Initialize real Butterworth low-pass filter of order N */
+SUBOOL su_iir_rfilt_bwlpf_init(su_iir_rfilt_t *filt, SUSCOUNT n, SUFLOAT fc);
+
+/* Initialize real Butterworth band-pass filter of order N */
+SUBOOL su_iir_rfilt_bwbpf_init(
+    su_iir_rfilt_t *filt,
+    SUSCOUNT n,
+    SUFLOAT f1,
+    SUFLOAT f2);
+
+/* Initialize real Butterworh high-pass filter of order N */
+SUBOOL su_iir_rfilt_bwhpf_init(su_iir_rfilt_t *filt, SUSCOUNT n, SUFLOAT fc);
+
+/* Initialize real Root Raised Cosine filter */
+SUBOOL su_iir_rfilt_rrc_init(
+    su_iir_rfilt_t *filt,
+    SUSCOUNT n,
+    SUFLOAT T,
+    SUFLOAT beta);
+
+/* Initialize real brickwall LPF filter */
+SUBOOL
+su_iir_rfilt_brickwall_lp_init(su_iir_rfilt_t *filt, SUSCOUNT n, SUFLOAT fc);
+
+/* Initialize real brickwall BPF filter */
+SUBOOL su_iir_rfilt_brickwall_bp_init(
+    su_iir_rfilt_t *filt,
+    SUSCOUNT n,
+    SUFLOAT bw,
+    SUFLOAT ifnor);
+
+/* Destroy real filter */
+void su_iir_rfilt_finalize(su_iir_rfilt_t *filt);
+
+/*
+ * Multi-stream filters. A single set of coefficients (taken from an
+ * existing filter) is applied to several independent complex streams.
+ * State is stored in structure-of-arrays form: the real and imaginary
+ * parts of every stream are 2 * streams lanes that go through exactly
+ * the same arithmetic, so all streams advance together in SIMD lanes.
+ */
+#define SU_IIR_MFILT_BLOCK 256
+
+struct sigutils_iir_mfilt {
+  unsigned int streams; /* Number of streams */
+  unsigned int lanes;   /* Real lanes (2 * streams) */
+
+  unsigned int x_size;
+  unsigned int y_size;
+
+  int x_ptr;
+  int y_ptr;
+
+  SUFLOAT *a;
+  SUFLOAT *b;
+
+  SUFLOAT *x; /* 2 * x_size rows of lanes, newest first */
+  SUFLOAT *y; /* 2 * y_size rows of lanes, newest first */
+
+  SUFLOAT gain;
+
+  unsigned int sos_count;
+  SUFLOAT *sos;       /* b0, b1, b2, a1, a2 of every section */
+  SUFLOAT *sos_state; /* Two rows of lanes per section */
+
+  SUCOMPLEX *scratch; /* SU_IIR_MFILT_BLOCK rows, for feed_streams */
+};
+
+typedef struct sigutils_iir_mfilt su_iir_mfilt_t;
+
+#define su_iir_mfilt_INITIALIZER                                           \
+  {                                                                        \
+    0, 0, 0, 0, 0, 0, NULL, NULL, NULL, NULL, 1, 0, NULL, NULL, NULL       \
+  }
+
+/* Initialize a multi-stream filter with the coefficients of proto */
+SUBOOL su_iir_mfilt_init(
+    su_iir_mfilt_t *filt,
+    const su_iir_filt_t *proto,
+    unsigned int streams);
+
+/*
+ * Feed len samples of every stream, interleaved: sample n of stream k
+ * is x[n * streams + k]. Outputs are written to y in the same layout.
+ */
+void su_iir_mfilt_feed_interleaved(
+    su_iir_mfilt_t *filt,
+    const SUCOMPLEX *x,
+    SUCOMPLEX *y,
+    SUSCOUNT len);
+
+/* Feed len samples of every stream, from one buffer per stream */
+void su_iir_mfilt_feed_streams(
+    su_iir_mfilt_t *filt,
+    const SUCOMPLEX *const *x,
+    SUCOMPLEX *const *y,
+    SUSCOUNT len);
+
+void su_iir_mfilt_reset(su_iir_mfilt_t *filt);
+
+void su_iir_mfilt_set_gain(su_iir_mfilt_t *filt, SUFLOAT gain);
+
+SUINLINE unsigned int
+su_iir_mfilt_get_streams(const su_iir_mfilt_t *filt)
+{
+  return filt->streams;
+}
+
+void su_iir_mfilt_finalize(su_iir_mfilt_t *filt);
+
 #ifdef __cplusplus
 #  ifdef __clang__
 #    pragma clang diagnostic pop
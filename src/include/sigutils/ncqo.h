@@ -29,17 +29,42 @@ extern "C" {
 #define SU_NCQO_USE_PRECALC_BUFFER  /**< Use a precalculated buffer for the oscillator. */
 #ifdef SU_NCQO_USE_PRECALC_BUFFER
 #  define SU_NCQO_PRECALC_BUFFER_LEN 1024
+
+/**
+ * Precalculated values of a fixed-frequency oscillator. These are only
+ * allocated by su_ncqo_init_fixed (and released by su_ncqo_finalize), so
+ * that oscillators in the other modes stay a few bytes large.
+ */
+struct sigutils_ncqo_precalc {
+  SUFLOAT phi_buffer[SU_NCQO_PRECALC_BUFFER_LEN]; /**< Precalculated angular positions of the oscillator */
+  SUFLOAT sin_buffer[SU_NCQO_PRECALC_BUFFER_LEN]; /**< Precalculated sine values of the oscillator */
+  SUFLOAT cos_buffer[SU_NCQO_PRECALC_BUFFER_LEN]; /**< Precalculated cosine values of the oscillator */
+};
 #endif /* SU_NCQO_USE_PRECALC_BUFFER */
 
+#define SU_NCQO_LUT_BITS 12 /**< Log2 of the size of the shared sine table */
+#define SU_NCQO_LUT_SIZE (1 << SU_NCQO_LUT_BITS)
+
+/**
+ * Phase representation of the oscillator. In the LUT modes, the phase is
+ * kept in a 32-bit fixed-point accumulator (2^32 is a full cycle), and
+ * sine and cosine are looked up in a table shared by all the oscillators
+ * of the process. The frequency is then exact to 2^-32 cycles per sample
+ * and the phase does not drift over long runs.
+ */
+enum sigutils_ncqo_mode {
+  SU_NCQO_MODE_FLOAT,      /**< Floating-point phase, exact sine and cosine */
+  SU_NCQO_MODE_LUT,        /**< Fixed-point phase, nearest table entry */
+  SU_NCQO_MODE_LUT_INTERP, /**< Fixed-point phase, interpolated table */
+};
+
 /**
  * This structure holds the internal state of an instance of a
  * numerically-controlled quadrature oscillator.
  */
 struct sigutils_ncqo {
 #ifdef SU_NCQO_USE_PRECALC_BUFFER
-  SUFLOAT phi_buffer[SU_NCQO_PRECALC_BUFFER_LEN]; /**< Precalculated angular positions of the oscillator */
-  SUFLOAT sin_buffer[SU_NCQO_PRECALC_BUFFER_LEN]; /**< Precalculated sine values of the oscillator */
-  SUFLOAT cos_buffer[SU_NCQO_PRECALC_BUFFER_LEN]; /**< Precalculated cosine values of the oscillator */
+  struct sigutils_ncqo_precalc *precalc; /**< Precalculated values (fixed oscillators only) */
   SUBOOL pre_c;   /**< Current instance is using precalculated values */
   unsigned int p; /**< Current index in use in the precalcalculated buffers */
 #endif            /* SU_NCQO_USE_PRECALC_BUFFER */
@@ -53,6 +78,10 @@ struct sigutils_ncqo {
 
   SUBOOL cos_updated; /**< Flag to indicate that cosine value is updated */
   SUFLOAT cos;        /**< Cosine value for the current angular position of the oscillator */
+
+  enum sigutils_ncqo_mode mode; /**< Phase representation */
+  uint32_t acc;  /**< Phase accumulator (LUT modes only) */
+  uint32_t dacc; /**< Phase increment per sample (LUT modes only) */
 };
 
 typedef struct sigutils_ncqo su_ncqo_t;
@@ -60,12 +89,14 @@ typedef struct sigutils_ncqo su_ncqo_t;
 #ifdef SU_NCQO_USE_PRECALC_BUFFER
 #  define su_ncqo_INITIALIZER                                               \
     {                                                                       \
-      {0.}, {0.}, {0.}, SU_FALSE, 0, 0., 0., 0., SU_FALSE, 0., SU_FALSE, 0. \
+      NULL, SU_FALSE, 0, 0., 0., 0., SU_FALSE, 0., SU_FALSE, 0.,             \
+          SU_NCQO_MODE_FLOAT, 0, 0                                           \
     }
 #else
 #  define su_ncqo_INITIALIZER                \
     {                                        \
-      0., 0., 0., SU_FALSE, 0., SU_FALSE, 0. \
+      0., 0., 0., SU_FALSE, 0., SU_FALSE, 0., \
+          SU_NCQO_MODE_FLOAT, 0, 0           \
     }
 #endif /* SU_NCQO_USE_PRECALC_BUFFER */
 
@@ -88,9 +119,28 @@ su_phase_adjust_one_cycle(SUFLOAT phi)
   return phi;
 }
 
+/* Conversions between angles and phase accumulator values */
+SUINLINE uint32_t
+su_ncqo_ang2acc(SUFLOAT phi)
+{
+  return (uint32_t) (int64_t) floor(
+      .5 + (double) phi * (4294967296. / (2 * M_PI)));
+}
+
+SUINLINE SUFLOAT
+su_ncqo_acc2ang(uint32_t acc)
+{
+  return (SUFLOAT) ((double) acc * (2 * M_PI / 4294967296.));
+}
+
 SUINLINE void
 __su_ncqo_step(su_ncqo_t *ncqo)
 {
+  if (ncqo->mode != SU_NCQO_MODE_FLOAT) {
+    ncqo->acc += ncqo->dacc;
+    return;
+  }
+
   ncqo->phi += ncqo->omega;
 
   if (ncqo->phi >= 2 * PI)
@@ -124,24 +174,24 @@ __su_ncqo_populate_precalc_buffer(su_ncqo_t *ncqo)
 #  endif /* SU_USE_VOLK */
   /* Precalculate phase buffer */
   for (i = 0; i < SU_NCQO_PRECALC_BUFFER_LEN; ++i) {
-    ncqo->phi_buffer[i] = ncqo->phi;
+    ncqo->precalc->phi_buffer[i] = ncqo->phi;
 #  ifndef SU_USE_VOLK
 #    ifdef HAVE_SINCOS
-    SU_SINCOS(ncqo->phi, ncqo->sin_buffer + i, ncqo->cos_buffer + i);
+    SU_SINCOS(ncqo->phi, ncqo->precalc->sin_buffer + i, ncqo->precalc->cos_buffer + i);
 #    else  /* HAVE_SINCOS */
-    ncqo->sin_buffer[i] = SU_SIN(ncqo->phi);
-    ncqo->cos_buffer[i] = SU_COS(ncqo->phi);
+    ncqo->precalc->sin_buffer[i] = SU_SIN(ncqo->phi);
+    ncqo->precalc->cos_buffer[i] = SU_COS(ncqo->phi);
 #    endif /* HAVE_SINCOS */
 #  else
     if ((i & SU_VOLK_CALL_STRIDE_MASK) == SU_VOLK_CALL_STRIDE_MASK) {
       p = i & ~SU_VOLK_CALL_STRIDE_MASK;
       volk_32f_sin_32f(
-          ncqo->sin_buffer + p,
-          ncqo->phi_buffer + p,
+          ncqo->precalc->sin_buffer + p,
+          ncqo->precalc->phi_buffer + p,
           SU_VOLK_CALL_STRIDE);
       volk_32f_cos_32f(
-          ncqo->cos_buffer + p,
-          ncqo->phi_buffer + p,
+          ncqo->precalc->cos_buffer + p,
+          ncqo->precalc->phi_buffer + p,
           SU_VOLK_CALL_STRIDE);
     }
 #  endif /* SU_USE_VOLK */
@@ -161,12 +211,34 @@ __su_ncqo_step_precalc(su_ncqo_t *ncqo)
 #endif /* SU_NCQO_USE_PRECALC_BUFFER */
 /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ VOLK HACKS ABOVE ^^^^^^^^^^^^^^^^^^^^^^^^^^^*/
 
-/* NCQO constructor */
+/*
+ * NCQO constructor. It does not release the precalculated values of a
+ * fixed NCQO, so it must not be called on one that has not been
+ * finalized with su_ncqo_finalize.
+ */
 SU_CONSTRUCTOR_TYPED(void, su_ncqo, SUFLOAT frel);
 
-/* NCQO constructor for fixed frequency */
+/*
+ * NCQO constructor for fixed frequency. The oscillator allocates its
+ * precalculated values, and must be released with su_ncqo_finalize.
+ */
 SU_METHOD(su_ncqo, void, init_fixed, SUFLOAT fnor);
 
+/* Release the precalculated values of a fixed NCQO (if any) */
+SU_METHOD(su_ncqo, void, finalize);
+
+/* NCQO constructor for the LUT modes */
+SU_METHOD(su_ncqo, void, init_lut, SUFLOAT fnor, SUBOOL interp);
+
+/* Change the phase representation, keeping phase and frequency */
+SU_METHOD(su_ncqo, SUBOOL, set_mode, enum sigutils_ncqo_mode mode);
+
+SUINLINE
+SU_GETTER(su_ncqo, enum sigutils_ncqo_mode, get_mode)
+{
+  return self->mode;
+}
+
 /* Init ncqo from existing ncqo */
 SU_METHOD(su_ncqo, void, copy, const su_ncqo_t *ncqo);
 
@@ -198,9 +270,12 @@ SU_GETTER(su_ncqo, SUFLOAT, get_phase)
 {
 #ifdef SU_NCQO_USE_PRECALC_BUFFER
   if (self->pre_c)
-    return self->phi_buffer[self->p];
+    return self->precalc->phi_buffer[self->p];
 #endif /* SU_NCQO_USE_PRECALC_BUFFER */
 
+  if (self->mode != SU_NCQO_MODE_FLOAT)
+    return su_ncqo_acc2ang(self->acc);
+
   return self->phi;
 }
 
@@ -217,6 +292,11 @@ SU_METHOD(su_ncqo, void, inc_phase, SUFLOAT delta)
   }
 #endif /* SU_NCQO_USE_PRECALC_BUFFER */
 
+  if (self->mode != SU_NCQO_MODE_FLOAT) {
+    self->acc += su_ncqo_ang2acc(delta);
+    return;
+  }
+
   self->phi += delta;
 
   if (self->phi < 0 || self->phi >= 2 * PI) {
@@ -241,6 +321,15 @@ SU_METHOD(su_ncqo, SUFLOAT, read_q);
 /* Read (compute next + get) both components as complex */
 SU_METHOD(su_ncqo, SUCOMPLEX, read);
 
+/* Read the next size samples at once (as calling read size times) */
+SU_METHOD(su_ncqo, void, read_bulk, SUCOMPLEX *out, SUSCOUNT size);
+
+/* Multiply buf in place by the next size samples of the oscillator */
+SU_METHOD(su_ncqo, void, mix_bulk, SUCOMPLEX *buf, SUSCOUNT size);
+
+/* Same as above, by their conjugates (i.e. shift buf down in frequency) */
+SU_METHOD(su_ncqo, void, mix_conj_bulk, SUCOMPLEX *buf, SUSCOUNT size);
+
 /* Set oscillator frequency (normalized angular freq) */
 SU_METHOD(su_ncqo, void, set_angfreq, SUFLOAT omrel);
 
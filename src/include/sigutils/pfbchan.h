@@ -0,0 +1,179 @@
+/*
+
+  Copyright (C) 2026 Gonzalo José Carracedo Carballal
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, version 3.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this program.  If not, see
+  <http://www.gnu.org/licenses/>
+
+*/
+
+#ifndef _SIGUTILS_PFBCHAN_H
+#define _SIGUTILS_PFBCHAN_H
+
+#include <sigutils/types.h>
+#include <sigutils/defs.h>
+
+#ifdef __cplusplus
+#  ifdef __clang__
+#    pragma clang diagnostic push
+#    pragma clang diagnostic ignored "-Wreturn-type-c-linkage"
+#  endif  // __clang__
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Polyphase filter bank channelizer. The input band is split in M equally
+ * spaced channels, with channel k centered at 2 * pi * k / M. All M
+ * channels are computed at once with a single M-point FFT per output
+ * sample, which makes this engine preferable to su_specttuner when most of
+ * the band must be channelized. Channels are either critically sampled
+ * (decimation M) or 2x oversampled (decimation M / 2).
+ */
+struct sigutils_pfbchan_params {
+  unsigned int channels;        /* Number of channels (M) */
+  unsigned int taps_per_branch; /* Prototype filter length divided by M */
+  SUFLOAT      bw;              /* Channel bandwidth, relative to spacing */
+  SUBOOL       oversample;      /* Decimate by M / 2 instead of M */
+  unsigned int block_size;      /* Samples per channel and callback */
+};
+
+#define sigutils_pfbchan_params_INITIALIZER \
+  {                                         \
+    64, /* channels */                      \
+    8, /* taps_per_branch */                \
+    1, /* bw */                             \
+    SU_FALSE, /* oversample */              \
+    512, /* block_size */                   \
+  }
+
+struct sigutils_pfbchan_channel;
+
+/* Same semantics as su_specttuner_channel_data_func_t */
+typedef SUBOOL (*su_pfbchan_channel_data_func_t) (
+    const struct sigutils_pfbchan_channel *channel,
+    void *privdata,
+    const SUCOMPLEX *data, /* This pointer remains valid until the next call to feed */
+    SUSCOUNT size);
+
+struct sigutils_pfbchan_channel_params {
+  unsigned int index; /* Channel index, from 0 to M - 1 */
+  void *privdata;     /* Private data */
+
+  /* Callbacks */
+  su_pfbchan_channel_data_func_t on_data;
+};
+
+#define sigutils_pfbchan_channel_params_INITIALIZER \
+  {                                                 \
+    0,        /* index */                           \
+        NULL, /* privdata */                        \
+        NULL  /* on_data */                         \
+  }
+
+struct sigutils_pfbchan_channel {
+  struct sigutils_pfbchan_channel_params params;
+  int index;         /* Back reference */
+  SUCOMPLEX *buffer; /* Channel output (block_size samples) */
+};
+
+typedef struct sigutils_pfbchan_channel su_pfbchan_channel_t;
+
+SUINLINE
+SU_GETTER(su_pfbchan_channel, unsigned int, get_index)
+{
+  return self->params.index;
+}
+
+struct sigutils_pfbchan {
+  struct sigutils_pfbchan_params params;
+  unsigned int decimation; /* Input samples per output sample */
+  unsigned int taps;       /* Prototype filter length */
+  SUFLOAT *h;              /* Prototype filter */
+
+  /*
+   * The last taps samples are kept in a circular buffer of twice that
+   * size. Every sample is written twice (p and p + taps), so that the
+   * filter history is always available at history + p, in order.
+   */
+  SUCOMPLEX *history;
+  unsigned int p;
+  unsigned int fill; /* Samples since the last output */
+
+  SU_FFTW(_complex) * branch; /* Polyphase branch outputs (M) */
+  SU_FFTW(_complex) * output; /* block_size FFTs of M bins each */
+  SU_FFTW(_plan) plan;
+  unsigned int out_p;  /* FFTs in output */
+  SUSCOUNT out_count;  /* Delivered output samples */
+
+  PTR_LIST(su_pfbchan_channel_t, channel);
+};
+
+typedef struct sigutils_pfbchan su_pfbchan_t;
+
+SUINLINE
+SU_GETTER(su_pfbchan, unsigned int, get_channel_count)
+{
+  return self->params.channels;
+}
+
+SUINLINE
+SU_GETTER(su_pfbchan, unsigned int, get_decimation)
+{
+  return self->decimation;
+}
+
+/* Central frequency of channel index (angular frequency) */
+SUINLINE
+SU_GETTER(su_pfbchan, SUFLOAT, get_channel_f0, unsigned int index)
+{
+  return 2 * PI * (SUFLOAT) index / (SUFLOAT) self->params.channels;
+}
+
+/* Index of the channel closest to angular frequency f0 */
+SUINLINE
+SU_GETTER(su_pfbchan, unsigned int, get_channel_index, SUFLOAT f0)
+{
+  SUFLOAT k = SU_FLOOR(.5 + f0 / (2 * PI) * self->params.channels);
+
+  k = SU_FMOD(k, self->params.channels);
+  if (k < 0)
+    k += self->params.channels;
+
+  return (unsigned int) k;
+}
+
+SU_INSTANCER(su_pfbchan, const struct sigutils_pfbchan_params *params);
+SU_COLLECTOR(su_pfbchan);
+
+SU_METHOD(su_pfbchan, SUBOOL, feed_bulk, const SUCOMPLEX *buf, SUSCOUNT size);
+
+SU_METHOD(
+    su_pfbchan,
+    su_pfbchan_channel_t *,
+    open_channel,
+    const struct sigutils_pfbchan_channel_params *params);
+
+SU_METHOD(
+    su_pfbchan,
+    SUBOOL,
+    close_channel,
+    su_pfbchan_channel_t *channel);
+
+#ifdef __cplusplus
+#  ifdef __clang__
+#    pragma clang diagnostic pop
+#  endif  // __clang__
+}
+#endif /* __cplusplus */
+
+#endif /* _SIGUTILS_PFBCHAN_H */
@@ -110,6 +110,13 @@ SU_METHOD(su_pll, void, inc_angfreq, SUFLOAT delta)
   su_ncqo_inc_angfreq(&self->ncqo, delta);
 }
 
+/* Phase representation of the loop oscillator */
+SUINLINE
+SU_METHOD(su_pll, SUBOOL, set_ncqo_mode, enum sigutils_ncqo_mode mode)
+{
+  return su_ncqo_set_mode(&self->ncqo, mode);
+}
+
 SUINLINE
 SU_GETTER(su_pll, SUFREQ, get_freq)
 {
@@ -150,6 +157,12 @@ SU_METHOD(su_costas, void, set_kind, enum sigutils_costas_kind kind);
 SU_METHOD(su_costas, void, set_loop_gain, SUFLOAT gain);
 SU_METHOD(su_costas, SUCOMPLEX, feed, SUCOMPLEX x);
 
+SUINLINE
+SU_METHOD(su_costas, SUBOOL, set_ncqo_mode, enum sigutils_ncqo_mode mode)
+{
+  return su_ncqo_set_mode(&self->ncqo, mode);
+}
+
 #ifdef __cplusplus
 #  ifdef __clang__
 #    pragma clang diagnostic pop
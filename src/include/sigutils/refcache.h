@@ -0,0 +1,116 @@
+/*
+
+  Copyright (C) 2026 Gonzalo José Carracedo Carballal
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, version 3.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this program.  If not, see
+  <http://www.gnu.org/licenses/>
+
+*/
+
+#ifndef _SIGUTILS_REFCACHE_H
+#define _SIGUTILS_REFCACHE_H
+
+#include <pthread.h>
+#include <sigutils/defs.h>
+#include <sigutils/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Reference-counted cache of immutable objects, for internal use (see
+ * design.c, lib.c, specttuner.c and window.c). Objects are looked up by
+ * key, created on a miss and shared by every user until the last one
+ * releases them.
+ * Objects that are no longer in use are kept around, and the least
+ * recently used ones are destroyed when there are more than max_idle of
+ * them, or when they add up to more than max_idle_size (in whatever
+ * units the cache accounts them). Objects are created and destroyed
+ * without holding the cache lock.
+ *
+ * Caches are either static (see su_refcache_INITIALIZER) or initialized
+ * with su_refcache_init and finalized with su_refcache_finalize.
+ */
+struct sigutils_refcache_entry {
+  const void  *data;      /* Handed to users, and given back on release */
+  SUSCOUNT     size;      /* Accounted size */
+  unsigned int refcount;
+  SUSCOUNT     last_used; /* Release tick, for eviction */
+};
+
+/*
+ * Caches store objects that embed a struct sigutils_refcache_entry as
+ * their first member, and look them up with keys of the same type.
+ */
+struct sigutils_refcache_class {
+  SUBOOL (*match)(
+      const struct sigutils_refcache_entry *entry,
+      const void *key);
+  struct sigutils_refcache_entry *(*create)(const void *key);
+  void (*destroy)(struct sigutils_refcache_entry *entry);
+
+  unsigned int max_idle;
+  SUSCOUNT     max_idle_size;
+};
+
+struct sigutils_refcache_stats {
+  SUSCOUNT hits;    /* Objects served from the cache */
+  SUSCOUNT misses;  /* Objects that had to be created */
+  SUSCOUNT entries; /* Objects currently in the cache */
+  SUSCOUNT idle;    /* Cached objects that are not in use */
+  SUSCOUNT size;    /* Accounted size of the cached objects */
+};
+
+struct sigutils_refcache {
+  const struct sigutils_refcache_class *classdata;
+  pthread_mutex_t mutex;
+  SUSCOUNT tick;
+  struct sigutils_refcache_stats stats;
+  PTR_LIST(struct sigutils_refcache_entry, entry);
+};
+
+typedef struct sigutils_refcache su_refcache_t;
+
+#define su_refcache_INITIALIZER(classdata)                             \
+  {                                                                    \
+    classdata, PTHREAD_MUTEX_INITIALIZER, 0, {0, 0, 0, 0, 0}, NULL, 0 \
+  }
+
+/* For caches that are not static */
+SU_CONSTRUCTOR(su_refcache, const struct sigutils_refcache_class *classdata);
+
+/* Destroys every object in the cache, in use or not */
+SU_DESTRUCTOR(su_refcache);
+
+/* Takes a reference to the object matching key, creating it if needed */
+SU_METHOD(
+    su_refcache,
+    const struct sigutils_refcache_entry *,
+    acquire,
+    const void *key);
+
+/* Returns SU_FALSE if data does not belong to the cache */
+SU_METHOD(su_refcache, SUBOOL, release, const void *data);
+
+SU_METHOD(
+    su_refcache,
+    void,
+    get_stats,
+    struct sigutils_refcache_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* _SIGUTILS_REFCACHE_H */
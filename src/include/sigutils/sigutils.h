@@ -40,10 +40,26 @@ SUBOOL su_lib_set_wisdom_file(const char *);
 SUBOOL su_lib_save_wisdom(void);
 void   su_lib_gen_wisdom(void);
 
+/* FFT plan cache */
+struct sigutils_plan_cache_stats {
+  SUSCOUNT hits;    /* Plans served from the cache */
+  SUSCOUNT misses;  /* Plans that had to be created */
+  SUSCOUNT entries; /* Plans currently in the cache */
+  SUSCOUNT idle;    /* Cached plans that are not in use */
+};
+
+void su_lib_get_plan_cache_stats(struct sigutils_plan_cache_stats *stats);
+
 /* Internal */
 int su_lib_fftw_strategy(void);
 SU_FFTW(_plan) su_lib_plan_dft_1d(int n, SU_FFTW(_complex) *in,
         SU_FFTW(_complex) *out, int sign, unsigned flags);
+SU_FFTW(_plan) su_lib_acquire_dft_plan(int n, int howmany,
+        SU_FFTW(_complex) *in, SU_FFTW(_complex) *out, int sign,
+        unsigned flags);
+SU_FFTW(_plan) su_lib_acquire_dft_r2c_plan(int n, SUFLOAT *in,
+        SU_FFTW(_complex) *out, unsigned flags);
+void su_lib_release_plan(SU_FFTW(_plan) plan);
 
 #ifdef __cplusplus
 }
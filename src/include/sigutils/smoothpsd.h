@@ -58,7 +58,7 @@ struct sigutils_smoothpsd {
 
   SUSCOUNT iters;
 
-  SU_FFTW(_complex) * window_func;
+  const SU_FFTW(_complex) * window_func; /* From the window cache */
   SU_FFTW(_complex) * buffer;
   SU_FFTW(_plan) fft_plan;
 
@@ -21,6 +21,7 @@
 #define _SIGUTILS_SOFTTUNE_H
 
 #include <sigutils/block.h>
+#include <sigutils/decim.h>
 #include <sigutils/iir.h>
 #include <sigutils/ncqo.h>
 #include <sigutils/sampling.h>
@@ -30,6 +31,15 @@
 #define SU_SOFTTUNER_ANTIALIAS_EXTRA_BW 2
 #define SU_SOFTTUNER_ANTIALIAS_ORDER 4
 
+/* Taps per decimation phase of the polyphase antialias filter */
+#define SU_SOFTTUNER_POLYPHASE_TAPS_PER_PHASE 16
+
+/* Fraction of the output band given to its transition band */
+#define SU_SOFTTUNER_POLYPHASE_TRANSITION SU_ADDSFX(.25)
+
+/* Input samples mixed with the LO at once */
+#define SU_SOFTTUNER_MIX_BLOCK 256
+
 struct sigutils_channel {
   SUFREQ fc;        /* Channel central frequency */
   SUFREQ f_lo;      /* Lower frequency belonging to the channel */
@@ -50,6 +60,8 @@ struct sigutils_softtuner_params {
   SUSCOUNT decimation;
   SUFREQ fc;
   SUFLOAT bw;
+  enum sigutils_ncqo_mode lo_mode; /* Phase representation of the LO */
+  SUBOOL polyphase; /* Decimate with a polyphase FIR instead of averaging */
 };
 
 #define sigutils_softtuner_params_INITIALIZER \
@@ -58,16 +70,20 @@ struct sigutils_softtuner_params {
         0, /* decimation */                   \
         0, /* fc */                           \
         0, /* bw */                           \
+        SU_NCQO_MODE_FLOAT, /* lo_mode */     \
+        SU_FALSE, /* polyphase */             \
   }
 
 struct sigutils_softtuner {
   struct sigutils_softtuner_params params;
   su_ncqo_t lo;            /* Local oscillator */
   su_iir_filt_t antialias; /* Antialiasing filter */
+  su_decim_t decim;        /* Polyphase decimator */
   su_stream_t output;      /* Output stream */
   su_off_t read_ptr;
   SUSCOUNT decim_ptr;
   SUBOOL filtered;
+  SUBOOL polyphase;
   SUFLOAT avginv;
 };
 
@@ -78,7 +94,18 @@ su_channel_detector_set_fc(su_softtuner_t *cd, SUFLOAT fc)
 {
   cd->params.fc = fc;
 
-  su_ncqo_init(&cd->lo, SU_ABS2NORM_FREQ(cd->params.samp_rate, cd->params.fc));
+  /* Fixed oscillators own their precalculated values */
+  su_ncqo_finalize(&cd->lo);
+
+  if (cd->params.lo_mode == SU_NCQO_MODE_FLOAT)
+    su_ncqo_init_fixed(
+        &cd->lo,
+        SU_ABS2NORM_FREQ(cd->params.samp_rate, cd->params.fc));
+  else
+    su_ncqo_init_lut(
+        &cd->lo,
+        SU_ABS2NORM_FREQ(cd->params.samp_rate, cd->params.fc),
+        cd->params.lo_mode == SU_NCQO_MODE_LUT_INTERP);
 }
 
 void su_softtuner_params_adjust_to_channel(
@@ -20,8 +20,10 @@
 #ifndef _SIGUTILS_SPECTTUNER_H
 #define _SIGUTILS_SPECTTUNER_H
 
+#include <pthread.h>
 #include <sigutils/defs.h>
 #include <sigutils/ncqo.h>
+#include <sigutils/refcache.h>
 #include <sigutils/types.h>
 
 #ifdef __cplusplus
@@ -33,9 +35,13 @@ extern "C" {
 #endif /* __cplusplus */
 
 struct sigutils_specttuner_params {
-  SUSCOUNT   window_size;
-  SUBOOL     early_windowing;
-  SUCOMPLEX *buffer;
+  SUSCOUNT     window_size;
+  SUBOOL       early_windowing;
+  SUCOMPLEX   *buffer;
+  unsigned int num_threads; /* Channel worker threads (<= 1: no pool) */
+  SUBOOL       real_input;  /* Real-valued input (see feed_bulk_real) */
+  unsigned int overlap;     /* Window overlap is window_size / overlap */
+  SUBOOL       background_planning; /* Measure channel plans off-thread */
 };
 
 #define sigutils_specttuner_params_INITIALIZER \
@@ -43,6 +49,10 @@ struct sigutils_specttuner_params {
     4096, /* window_size */                    \
     SU_TRUE, /* early_windowing */             \
     NULL, /* buffer */                         \
+    0, /* num_threads */                       \
+    SU_FALSE, /* real_input */                 \
+    2, /* overlap */                           \
+    SU_FALSE, /* background_planning */        \
   }
 
 enum sigutils_specttuner_state {
@@ -57,6 +67,10 @@ enum sigutils_specttuner_channel_domain {
 
 struct sigutils_specttuner_channel;
 
+/*
+ * If the channel is squelched during a window, data is NULL and size is
+ * the number of samples that would have been delivered otherwise.
+ */
 typedef SUBOOL (*su_specttuner_channel_data_func_t) (
     const struct sigutils_specttuner_channel *channel,
     void *privdata,
@@ -69,6 +83,16 @@ typedef void (*su_specttuner_channel_new_freq_func_t) (
     SUFLOAT prev_f0,
     SUFLOAT new_f0);
 
+/*
+ * Glue kernel. Applies the window, the LO correction and the gain to the
+ * first hopsz samples of the current IFFT, overlapping them with the tail
+ * of the previous one. Kernels are specialized for each channel
+ * configuration and picked when the channel is opened.
+ */
+typedef void (*su_specttuner_glue_func_t) (
+    struct sigutils_specttuner_channel *channel,
+    SUCOMPLEX *curr);
+
 struct sigutils_specttuner_channel_params {
   SUFLOAT f0;      /* Central frequency (angular frequency) */
   SUFLOAT delta_f; /* Frequency correction (angular frequency) */
@@ -81,6 +105,8 @@ struct sigutils_specttuner_channel_params {
   /* Callbacks */
   su_specttuner_channel_data_func_t     on_data;
   su_specttuner_channel_new_freq_func_t on_freq_changed;
+
+  SUFLOAT squelch; /* Output power threshold (0: disabled) */
 };
 
 #define sigutils_specttuner_channel_params_INITIALIZER  \
@@ -93,39 +119,136 @@ struct sigutils_specttuner_channel_params {
         SU_SPECTTUNER_CHANNEL_TIME_DOMAIN, /* domain */ \
         NULL,     /* private */                         \
         NULL,     /* on_data */                         \
-        NULL      /* on_freq_changed */                 \
+        NULL,     /* on_freq_changed */                 \
+        0         /* squelch */                         \
   }
 
+struct sigutils_specttuner_group;
+
+/*
+ * Filter responses only depend on the window size, the channel half width
+ * and the scaling factor. Channels sharing them share the same response,
+ * which is computed once and kept in the tuner's filter cache for as long
+ * as there is a channel using it.
+ */
+struct sigutils_specttuner_filter_cache;
+
+struct sigutils_specttuner_filter {
+  struct sigutils_refcache_entry header; /* data: the filter itself */
+  struct sigutils_specttuner_filter_cache *cache; /* Owner */
+  unsigned int halfw;    /* Half of channel width */
+  SUFLOAT      k;        /* Scaling factor */
+  SU_FFTW(_complex) * h; /* Frequency response of filter */
+};
+
+typedef struct sigutils_specttuner_filter su_specttuner_filter_t;
+
+struct sigutils_specttuner_filter_cache {
+  unsigned int window_size;
+  SU_FFTW(_plan) forward;  /* Filter response forward plan */
+  SU_FFTW(_plan) backward; /* Filter response backward plan */
+  SU_FFTW(_complex) * buffer; /* Planning buffer */
+  const SUFLOAT *window;      /* Blackmann-Harris window (window cache) */
+
+  su_refcache_t responses; /* Responses in use, keyed by halfw and k */
+  SUBOOL responses_init;
+};
+
+typedef struct sigutils_specttuner_filter_cache su_specttuner_filter_cache_t;
+
+SU_INSTANCER(su_specttuner_filter_cache, unsigned int window_size);
+SU_COLLECTOR(su_specttuner_filter_cache);
+
+SU_METHOD(
+    su_specttuner_filter_cache,
+    su_specttuner_filter_t *,
+    acquire,
+    unsigned int halfw,
+    SUFLOAT k);
+
+SU_METHOD(
+    su_specttuner_filter_cache,
+    void,
+    release,
+    su_specttuner_filter_t *filter);
+
+/*
+ * Channel local oscillator. Channel LOs are only read in bulk, once per
+ * window, so they do not need the per-sample state of su_ncqo_t (nor its
+ * precalculated tables, which would make every channel several kilobytes
+ * large). As in the LUT modes of su_ncqo_t, the phase is kept in a 32-bit
+ * fixed-point accumulator, so it does not drift over long runs.
+ */
+struct sigutils_specttuner_lo {
+  uint32_t acc;  /* Current phase (2^32 is a full cycle) */
+  uint32_t dacc; /* Phase increment per sample */
+};
+
+typedef struct sigutils_specttuner_lo su_specttuner_lo_t;
+
+/*
+ * Channel fields are laid out by access frequency. Everything touched by
+ * the per-window loops comes first, so that a channel spans a few cache
+ * lines. Configuration and bookkeeping go last.
+ */
 struct sigutils_specttuner_channel {
+  /*
+   * The inverse FFT is performed by the channel group, in a single batch
+   * for all channels of the same size. Both fft and ifft point to this
+   * channel's slot in the group buffers. Since these buffers are reused
+   * on every window, the second half of the last IFFT (needed to perform
+   * a good windowing that does not rely on rectangular windows) is kept
+   * in tail.
+   */
+  SU_FFTW(_complex) * fft;  /* Filtered spectrum (group buffer) */
+  SU_FFTW(_complex) * ifft; /* Time-domain signal (group buffer) */
+  SU_FFTW(_complex) * tail; /* Second half of the previous IFFT */
+  const SU_FFTW(_complex) * h; /* Frequency response of filter */
+  const SUFLOAT *window;       /* Window function (window cache) */
+  SUCOMPLEX *phase;            /* LO phasors of the current window (precise) */
+
+  su_specttuner_glue_func_t glue;        /* Glue kernel */
+  su_specttuner_glue_func_t glue_retune; /* Same, when changing frequency */
+
+  SUFLOAT k;               /* Scaling factor */
+  SUFLOAT gain;            /* Channel gain */
+  unsigned int center;     /* FFT center bin */
+  unsigned int old_center; /* FFT center bin of the previous window */
+  unsigned int size;       /* FFT bins to allocate */
+  unsigned int width;      /* FFT bins to copy (for guard bands, etc) */
+  unsigned int halfw;      /* Half of channel width */
+  unsigned int halfsz;     /* Half of window size */
+  unsigned int hopsz;      /* Samples delivered per window */
+  unsigned int ovsz;       /* Samples shared by consecutive windows */
+  su_specttuner_lo_t lo;     /* Local oscillator to correct imprecise centering */
+  su_specttuner_lo_t old_lo; /* Copy of the old local oscillator */
+  SUBOOL pending_freq;       /* Pending frequency adjustment */
+  SUBOOL changing_freqs;     /* Frequency adjusted in the current window */
+  SUBOOL freq_domain;        /* Frequency domain in the current window */
+
+  /*
+   * Squelch. The power of the channel output is estimated from its
+   * filtered spectrum. Windows below the squelch level skip the
+   * inverse FFT entirely and are signaled to on_data with a NULL
+   * data pointer.
+   */
+  SUFLOAT power;       /* Estimated power of the last window */
+  SUBOOL squelched;    /* Current window is below the squelch level */
+  SUBOOL silent_tail;  /* Tail of the previous window is all zeros */
+
   struct sigutils_specttuner_channel_params params;
+
+  /* Cold fields */
   int index; /* Back reference */
+  struct sigutils_specttuner_group *group; /* Same-size channel group */
+  unsigned int slot;                        /* Slot inside the group */
 
-  SUFLOAT k;           /* Scaling factor */
-  SUFLOAT gain;        /* Channel gain */
   SUFLOAT decimation;  /* Equivalent decimation */
-  su_ncqo_t lo;        /* Local oscillator to correct imprecise centering */
-  su_ncqo_t old_lo;    /* Copy of the old local oscillator */
-  SUBOOL pending_freq; /* Pending frequency adjustment */
   SUFLOAT old_f0;      /* Old frequency */
-  unsigned int center; /* FFT center bin */
-  unsigned int size;   /* FFT bins to allocate */
-  unsigned int width;  /* FFT bins to copy (for guard bands, etc) */
-  unsigned int halfw;  /* Half of channel width */
-  unsigned int halfsz; /* Half of window size */
   unsigned int offset; /* Window offset for overlapping */
 
-  /*
-   * Again, we have to keep 2 buffers: this way we can perform
-   * a good windowing that does not rely on rectangular windows
-   */
-  SU_FFTW(_complex) * fft; /* Filtered spectrum */
-  SU_FFTW(_complex) * h;   /* Frequency response of filter */
-  SU_FFTW(_plan) plan[2];  /* Even & Odd plans */
-  SU_FFTW(_plan) forward;  /* Filter response forward plan */
-  SU_FFTW(_plan) backward; /* Filter response backward plan */
-
-  SU_FFTW(_complex) * ifft[2]; /* Even & Odd time-domain signal */
-  SUFLOAT *window;             /* Window function */
+  su_specttuner_filter_t *filter; /* Shared filter response */
+  SU_FFTW(_plan) seed_plan;       /* Single transform plan, for its group */
 };
 
 typedef struct sigutils_specttuner_channel su_specttuner_channel_t;
@@ -165,6 +288,19 @@ SU_METHOD(
   self->params.domain = dom;
 }
 
+SUINLINE
+SU_METHOD(su_specttuner_channel, void, set_squelch, SUFLOAT level)
+{
+  self->params.squelch = level;
+}
+
+/* Only updated if the squelch is enabled */
+SUINLINE
+SU_GETTER(su_specttuner_channel, SUFLOAT, get_power)
+{
+  return self->power;
+}
+
 SUINLINE
 SU_GETTER(su_specttuner_channel, SUFLOAT, get_effective_freq)
 {
@@ -176,8 +312,47 @@ SU_GETTER(su_specttuner_channel, SUFLOAT, get_effective_freq)
   return ef;
 }
 
+/*
+ * Channels of the same size are grouped together, and their inverse FFTs
+ * are computed in batches over a contiguous buffer with one slot per
+ * channel. In order to avoid replanning every time a channel is opened or
+ * closed, the group keeps plans for batches of 1, 2, 4, ... 2^n transforms
+ * and covers the number of active slots with its binary decomposition.
+ * Frequency-domain channels (which need no inverse FFT) are kept in the
+ * last slots, and squelched channels are moved past the active slots on
+ * every window.
+ */
+struct sigutils_specttuner_group {
+  unsigned int size;       /* Transform size */
+  unsigned int capacity;   /* Allocated slots (always a power of 2) */
+  unsigned int count;      /* Slots in use */
+  unsigned int time_count; /* Time-domain slots (the first ones) */
+  unsigned int active;     /* Slots to transform in this window */
+
+  struct sigutils_specttuner_channel **member_list; /* One per slot */
+
+  SU_FFTW(_complex) * fft;  /* capacity * size filtered spectra */
+  SU_FFTW(_complex) * ifft; /* capacity * size time-domain signals */
+
+  unsigned int plan_count;  /* Plan i computes 2^i transforms */
+  SU_FFTW(_plan) * plan_list;
+
+  /*
+   * With background planning, plans are provided by the planner thread
+   * and may be missing (NULL) for a while. Missing batches are computed
+   * with plan 0, which is always available.
+   */
+  SUBOOL deferred;        /* Plans provided by the background planner */
+  unsigned int requested; /* Plans requested to the planner (bitmask) */
+  unsigned int measured;  /* Plans computed by the planner (bitmask) */
+};
+
+typedef struct sigutils_specttuner_group su_specttuner_group_t;
+
 struct sigutils_specttuner_plan {
-  SU_FFTW(_plan) plans[2]; /* Even and odd plans */
+  SU_FFTW(_plan) plans[2]; /* Even and odd plans (shared) */
+  SUCOMPLEX *in[2];        /* Even and odd input */
+  SUCOMPLEX *out;
 };
 
 typedef struct sigutils_specttuner_plan su_specttuner_plan_t;
@@ -188,9 +363,129 @@ SU_COLLECTOR(su_specttuner_plan);
 SUINLINE
 SU_METHOD(su_specttuner_plan, void, execute, int which)
 {
-  SU_FFTW(_execute)(self->plans[which]);
+  SU_FFTW(_execute_dft)(
+      self->plans[which],
+      (SU_FFTW(_complex) *) self->in[which],
+      (SU_FFTW(_complex) *) self->out);
 }
 
+/*
+ * Channel worker pool. When the tuner is created with num_threads > 1,
+ * the channel list is split across num_threads - 1 worker threads plus
+ * the thread that feeds the tuner. Channel callbacks are then invoked
+ * from any of these threads, but never concurrently for the same
+ * channel. Feeding returns only after every channel has been served,
+ * so the next window is never accepted before all workers are done.
+ */
+struct sigutils_specttuner;
+struct sigutils_specttuner_pool;
+
+typedef SUBOOL (*su_specttuner_pool_job_t) (
+    struct sigutils_specttuner *owner,
+    unsigned int index,
+    unsigned int count);
+
+struct sigutils_specttuner_worker {
+  struct sigutils_specttuner_pool *pool;
+  unsigned int index;
+  pthread_t    thread;
+  SUBOOL       thread_running;
+};
+
+typedef struct sigutils_specttuner_worker su_specttuner_worker_t;
+
+struct sigutils_specttuner_pool {
+  struct sigutils_specttuner *owner;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t  job_cond;  /* New job available or halt requested */
+  pthread_cond_t  done_cond; /* All workers finished the current job */
+  SUBOOL          mutex_init;
+  SUBOOL          job_cond_init;
+  SUBOOL          done_cond_init;
+
+  su_specttuner_pool_job_t job;
+  unsigned int epoch;   /* Incremented every time a job is posted */
+  unsigned int pending; /* Workers that have not finished the job yet */
+  SUBOOL       ok;      /* Accumulated result of the job */
+  SUBOOL       halt;
+
+  unsigned int worker_count; /* Including the calling thread */
+  su_specttuner_worker_t *worker_list;
+};
+
+typedef struct sigutils_specttuner_pool su_specttuner_pool_t;
+
+SU_INSTANCER(
+    su_specttuner_pool,
+    struct sigutils_specttuner *owner,
+    unsigned int count);
+SU_COLLECTOR(su_specttuner_pool);
+
+SU_METHOD(su_specttuner_pool, SUBOOL, run, su_specttuner_pool_job_t job);
+
+/*
+ * Channel commands. Channels can be opened, closed and retuned from any
+ * thread by posting commands to the tuner, which runs them in the feeding
+ * thread right before the next window is delivered. Commands are pushed
+ * to a lock-free stack that is detached at once by the feeding thread, so
+ * neither side ever waits for the other.
+ */
+enum sigutils_specttuner_command_type {
+  SU_SPECTTUNER_COMMAND_OPEN,
+  SU_SPECTTUNER_COMMAND_CLOSE,
+  SU_SPECTTUNER_COMMAND_SET_FREQ,
+  SU_SPECTTUNER_COMMAND_SET_DELTA_F,
+  SU_SPECTTUNER_COMMAND_SWAP_PLAN,    /* From the planner */
+  SU_SPECTTUNER_COMMAND_PLAN,         /* To the planner */
+  SU_SPECTTUNER_COMMAND_RELEASE_PLAN, /* To the planner */
+};
+
+struct sigutils_specttuner_command {
+  struct sigutils_specttuner_command *next;
+  enum sigutils_specttuner_command_type type;
+  struct sigutils_specttuner_channel *channel;
+  SUFLOAT value;
+
+  /* Plan commands */
+  su_specttuner_group_t *group;
+  unsigned int size;  /* Transform size of the group */
+  unsigned int index; /* Plan index in the group */
+  SU_FFTW(_plan) plan;
+};
+
+typedef struct sigutils_specttuner_command su_specttuner_command_t;
+
+/*
+ * Background planner. Planning a batch with FFTW_MEASURE (or worse) may
+ * take tens of milliseconds, during which the feeding thread would be
+ * stalled. When background_planning is enabled, channel groups never plan
+ * in the feeding thread: they start with the FFTW_ESTIMATE plan brought by
+ * their first channel and ask the planner for the rest. Plans computed
+ * with the library strategy are posted back to the tuner as commands and
+ * swapped in at the next window. Releasing plans is also left to the
+ * planner, as it contends for the same lock.
+ */
+struct sigutils_specttuner_planner {
+  struct sigutils_specttuner *owner;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t  cond;
+  SUBOOL          mutex_init;
+  SUBOOL          cond_init;
+  SUBOOL          halt;
+
+  pthread_t thread;
+  SUBOOL    thread_running;
+
+  su_specttuner_command_t *jobs; /* Pending jobs, most recent first */
+};
+
+typedef struct sigutils_specttuner_planner su_specttuner_planner_t;
+
+SU_INSTANCER(su_specttuner_planner, struct sigutils_specttuner *owner);
+SU_COLLECTOR(su_specttuner_planner);
+
 /*
  * The spectral tuner leverages its 3/2-sized window buffer by keeping
  * two FFT plans (even & odd) and conditionally saving the same sample
@@ -214,27 +509,58 @@ SU_METHOD(su_specttuner_plan, void, execute, int which)
  * During the ODD state, we fill the remaining half of the odd part, but
  * also the first half of the even part. When the ODD part is full, the
  * odd plan is performed as well as the usual frequency filtering.
+ *
+ * In real input mode, the same scheme is applied to a buffer of real
+ * samples, which is transformed by a real-to-complex FFT. Only the
+ * first window_size / 2 + 1 bins are computed, and channels lying in
+ * the upper half of the spectrum are extracted from the conjugate of
+ * their mirror image in the lower half.
  */
 
 struct sigutils_specttuner {
   struct sigutils_specttuner_params params;
 
-  SUFLOAT           * wfunc;  /* Window function */
+  const SUFLOAT     * wfunc;  /* Window function (window cache) */
   SU_FFTW(_complex) * buffer; /* 3/2 the space, double allocation trick */
   SU_FFTW(_complex) * fft;
 
+  SUFLOAT        *real_buffer;  /* Same as buffer, for real input mode */
+  SU_FFTW(_plan)  real_plan[2]; /* Even & odd r2c plans */
+
   enum sigutils_specttuner_state state;
   su_specttuner_plan_t *default_plan;
 
   unsigned int half_size; /* 3/2 of window size */
   unsigned int p;         /* From 0 to window_size - 1 */
 
+  /*
+   * Overlaps below 50% do not use the three thirds buffer. Instead, the
+   * window is stored linearly and the overlapping part is moved to the
+   * beginning of the buffer after every FFT. The state is always even.
+   */
+  SUBOOL linear;             /* Linear buffer (overlap below 50%) */
+  unsigned int overlap_size; /* Samples shared by consecutive windows */
+  unsigned int hop_size;     /* New samples per window */
+  unsigned int hop_phase;    /* Start of the last window, modulo window_size */
+
   unsigned int count; /* Active channels */
 
   SUBOOL ready; /* FFT ready */
 
+  su_specttuner_pool_t *pool; /* Channel worker pool (optional) */
+  su_specttuner_planner_t *planner; /* Background planner (optional) */
+
   /* Channel list */
-  PTR_LIST(struct sigutils_specttuner_channel, channel);
+  PTR_SLOTMAP(struct sigutils_specttuner_channel, channel);
+
+  /* Pending channel commands, most recent first */
+  su_specttuner_command_t *commands;
+
+  /* Filter responses shared by channels */
+  su_specttuner_filter_cache_t *filter_cache;
+
+  /* Same-size channel groups */
+  PTR_LIST(su_specttuner_group_t, group);
 
   /* Plan allocation */
   PTR_LIST(su_specttuner_plan_t, plan)
@@ -272,52 +598,78 @@ SU_GETTER(su_specttuner, SUBOOL, uses_early_windowing)
   return self->params.early_windowing;
 }
 
-
-#ifndef __cplusplus
-
 /* Internal */
 SU_METHOD(su_specttuner, SUBOOL, feed_all_channels);
 
 /* Internal */
 SU_METHOD(su_specttuner, void, run_fft, su_specttuner_plan_t *);
 
+/* Internal */
+SU_METHOD(su_specttuner, void, complete_window, su_specttuner_plan_t *);
+
+/*
+ * Complex input mode only. There is no buffer for complex samples in real
+ * input mode, and this method does not check it.
+ */
 SUINLINE
 SU_METHOD(su_specttuner, SUBOOL, feed_sample, SUCOMPLEX x)
 {
+  SUCOMPLEX *buffer = (SUCOMPLEX *) self->buffer;
   SUSDIFF halfsz = self->half_size;
   SUSDIFF p = self->p;
 
   switch (self->state) {
     case SU_SPECTTUNER_STATE_EVEN:
       /* Just copy at the beginning */
-      self->buffer[p] = x;
+      buffer[p] = x;
       break;
 
     case SU_SPECTTUNER_STATE_ODD:
       /* Copy to the second third */
-      self->buffer[p + halfsz] = x;
+      buffer[p + halfsz] = x;
 
       /* Are we populating the last third too? */
       if (p >= halfsz)
-        self->buffer[p - halfsz] = x;
+        buffer[p - halfsz] = x;
   }
 
-  if (++p < self->params.window_size) {
+  if (++p < (SUSDIFF) self->params.window_size)
     self->p = p;
-  } else {
-    self->p = halfsz;
+  else
+    su_specttuner_complete_window(self, self->default_plan);
+
+  return self->ready;
+}
+
+/*
+ * Real input mode only. As with feed_sample, the mode of the tuner is not
+ * checked.
+ */
+SUINLINE
+SU_METHOD(su_specttuner, SUBOOL, feed_sample_real, SUFLOAT x)
+{
+  SUSDIFF halfsz = self->half_size;
+  SUSDIFF p = self->p;
+
+  switch (self->state) {
+    case SU_SPECTTUNER_STATE_EVEN:
+      self->real_buffer[p] = x;
+      break;
 
-    /* Compute FFT */
-    su_specttuner_run_fft(self, self->default_plan);
+    case SU_SPECTTUNER_STATE_ODD:
+      self->real_buffer[p + halfsz] = x;
 
-    /* Toggle state */
-    self->state = !self->state;
-    self->ready = SU_TRUE;
+      if (p >= halfsz)
+        self->real_buffer[p - halfsz] = x;
   }
 
+  if (++p < (SUSDIFF) self->params.window_size)
+    self->p = p;
+  else
+    su_specttuner_complete_window(self, NULL);
+
   return self->ready;
 }
-#endif /* __cplusplus */
 
 SU_INSTANCER(su_specttuner, const struct sigutils_specttuner_params *params);
 SU_COLLECTOR(su_specttuner);
@@ -336,6 +688,33 @@ SU_METHOD(
     const SUCOMPLEX *__restrict buf,
     SUSCOUNT size);
 
+/* Real input mode only */
+SU_METHOD(
+    su_specttuner,
+    SUSDIFF,
+    feed_bulk_single_real,
+    const SUFLOAT *__restrict buf,
+    SUSCOUNT size);
+
+SU_METHOD(
+    su_specttuner,
+    SUBOOL,
+    feed_bulk_real,
+    const SUFLOAT *__restrict buf,
+    SUSCOUNT size);
+
+/*
+ * Zero-copy input. acquire (or acquire_real, in real input mode) returns
+ * the position of the tuner buffer in which the next samples must be
+ * written, along with the number of samples that fit there (avail). Once
+ * the samples are in place, commit must be called with size <= avail.
+ * If this completes the window, commit computes the FFT and feeds the
+ * channels. The returned pointer is no longer valid after commit.
+ */
+SU_METHOD(su_specttuner, SUCOMPLEX *, acquire, SUSCOUNT *avail);
+SU_METHOD(su_specttuner, SUFLOAT *, acquire_real, SUSCOUNT *avail);
+SU_METHOD(su_specttuner, SUBOOL, commit, SUSCOUNT size);
+
 /* The FFT is triggered from a circular buffer. */
 SU_METHOD(su_specttuner, SUBOOL, trigger, su_specttuner_plan_t *);
 
@@ -378,6 +757,39 @@ SU_METHOD_CONST(
     su_specttuner_channel_t *channel,
     SUFLOAT bw);
 
+/*
+ * Thread-safe counterparts of the methods above. open_channel_async
+ * builds the channel in the calling thread and returns it right away,
+ * although it will not receive data until the next window. Once
+ * close_channel_async returns, the channel must not be used again (its
+ * callbacks may still be called until the next window, though).
+ */
+SU_METHOD(
+    su_specttuner,
+    su_specttuner_channel_t *,
+    open_channel_async,
+    const struct sigutils_specttuner_channel_params *params);
+
+SU_METHOD(
+    su_specttuner,
+    SUBOOL,
+    close_channel_async,
+    su_specttuner_channel_t *channel);
+
+SU_METHOD(
+    su_specttuner,
+    SUBOOL,
+    set_channel_freq_async,
+    su_specttuner_channel_t *channel,
+    SUFLOAT f0);
+
+SU_METHOD(
+    su_specttuner,
+    SUBOOL,
+    set_channel_delta_f_async,
+    su_specttuner_channel_t *channel,
+    SUFLOAT delta_f);
+
 #ifdef __cplusplus
 #  ifdef __clang__
 #    pragma clang diagnostic pop
@@ -77,7 +77,7 @@ struct sigutils_pulse_finder {
 
   SUFLOAT last_y;
 
-  su_iir_filt_t corr;
+  su_iir_rfilt_t corr;
   SUBOOL present;
   SUFLOAT accum;
   SUFLOAT w_accum;
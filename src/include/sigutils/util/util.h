@@ -96,6 +96,63 @@
        JOIN(_idx_, __LINE__)++)                                                \
     if ((this = where->name##_list[JOIN(_idx_, __LINE__)]) != NULL)
 
+/*
+ * Pointer slot map. Live elements are always packed at the beginning of
+ * the list, and every element is identified by a stable handle that remains
+ * valid until it is removed. Insertion and removal take constant time:
+ * removing an element moves the last one to its position. The list and the
+ * element count are declared with the usual PTR_LIST names, and the handle
+ * bookkeeping lives next to them.
+ */
+struct ptr_slotmap {
+  unsigned int alloc;     /* Allocated entries */
+  unsigned int handles;   /* Handles issued so far */
+  unsigned int next_free; /* Last released handle plus one, or 0 */
+  unsigned int *slot;     /* Position of each handle in the list */
+  unsigned int *handle;   /* Handle of each position of the list */
+};
+
+typedef struct ptr_slotmap ptr_slotmap_t;
+
+#define PTR_SLOTMAP(type, name) \
+  type **name##_list;           \
+  unsigned int name##_count;    \
+  ptr_slotmap_t name##_map;
+
+#define PTR_SLOTMAP_INSERT(name, ptr) \
+  ptr_slotmap_insert(                 \
+      (void ***)&JOIN(name, _list),   \
+      &JOIN(name, _count),            \
+      &JOIN(name, _map),              \
+      ptr)
+
+#define PTR_SLOTMAP_GET(name, handle) \
+  ptr_slotmap_get(                    \
+      (void **)JOIN(name, _list),     \
+      JOIN(name, _count),             \
+      &JOIN(name, _map),              \
+      handle)
+
+#define PTR_SLOTMAP_REMOVE(name, handle) \
+  ptr_slotmap_remove(                    \
+      (void **)JOIN(name, _list),        \
+      &JOIN(name, _count),               \
+      &JOIN(name, _map),                 \
+      handle)
+
+#define PTR_SLOTMAP_REMOVE_AT(name, pos) \
+  ptr_slotmap_remove_at(                 \
+      (void **)JOIN(name, _list),        \
+      &JOIN(name, _count),               \
+      &JOIN(name, _map),                 \
+      pos)
+
+#define PTR_SLOTMAP_FINALIZE(name) \
+  ptr_slotmap_finalize(            \
+      (void ***)&JOIN(name, _list), \
+      &JOIN(name, _count),         \
+      &JOIN(name, _map))
+
 #define __UNITS(x, wrdsiz) ((((x) + (wrdsiz - 1)) / wrdsiz))
 #define __ALIGN(x, wrdsiz) (__UNITS(x, wrdsiz) * wrdsiz)
 
@@ -186,6 +243,12 @@ int ptr_list_append_check(void ***, unsigned int *, void *);
 int ptr_list_remove_first(void ***, unsigned int *, void *);
 int ptr_list_remove_all(void ***, int *, void *);
 
+void ptr_slotmap_finalize(void ***, unsigned int *, ptr_slotmap_t *);
+int ptr_slotmap_insert(void ***, unsigned int *, ptr_slotmap_t *, void *);
+void *ptr_slotmap_get(void **, unsigned int, const ptr_slotmap_t *, int);
+void ptr_slotmap_remove_at(void **, unsigned int *, ptr_slotmap_t *, unsigned int);
+int ptr_slotmap_remove(void **, unsigned int *, ptr_slotmap_t *, int);
+
 void errno_save(void);
 void errno_restore(void);
 
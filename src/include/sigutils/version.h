@@ -40,7 +40,7 @@ extern "C" {
 #define SIGUTILS_VERSION_PATCH 0
 
 /* ABI version macros */
-#define SIGUTILS_ABI_VERSION 1
+#define SIGUTILS_ABI_VERSION 2
 
 /* Utility macros */
 #define __SU_VN(num, shift) ((uint32_t)((uint8_t)(num)) << (shift))
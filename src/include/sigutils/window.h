@@ -0,0 +1,78 @@
+/*
+
+  Copyright (C) 2026 Gonzalo José Carracedo Carballal
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, version 3.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this program.  If not, see
+  <http://www.gnu.org/licenses/>
+
+*/
+
+#ifndef _SIGUTILS_WINDOW_H
+#define _SIGUTILS_WINDOW_H
+
+#include <sigutils/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+enum sigutils_window_kind {
+  SU_WINDOW_RECTANGULAR,
+  SU_WINDOW_HAMMING,
+  SU_WINDOW_HANN,
+  SU_WINDOW_FLAT_TOP,
+  SU_WINDOW_BLACKMANN_HARRIS
+};
+
+/*
+ * Window table cache. Window functions are computed once per kind, size
+ * and sample type, and the resulting tables are shared by every object
+ * that requests them, so windowing a buffer is just a product by the
+ * table. Tables are aligned as fftw(f)_malloc does, must not be modified
+ * and are returned to the cache with su_window_release. Unused tables are
+ * kept around (up to SU_WINDOW_CACHE_MAX_IDLE of them, taking no more than
+ * SU_WINDOW_CACHE_MAX_IDLE_SIZE bytes) for future requests.
+ */
+#define SU_WINDOW_CACHE_MAX_IDLE      16
+#define SU_WINDOW_CACHE_MAX_IDLE_SIZE (16 << 20)
+
+struct sigutils_window_cache_stats {
+  SUSCOUNT hits;    /* Tables served from the cache */
+  SUSCOUNT misses;  /* Tables that had to be computed */
+  SUSCOUNT entries; /* Tables currently in the cache */
+  SUSCOUNT idle;    /* Cached tables that are not in use */
+  SUSCOUNT size;    /* Bytes held by the cache */
+};
+
+const SUFLOAT *su_window_acquire(enum sigutils_window_kind kind, SUSCOUNT size);
+
+const SUCOMPLEX *su_window_acquire_complex(
+    enum sigutils_window_kind kind,
+    SUSCOUNT size);
+
+/*
+ * Window whose first and last overlap samples are tapered by squared sine
+ * halves, so that windows placed size - overlap samples apart add up to 1.
+ * For overlap = size / 2 this is the regular squared sine window.
+ */
+const SUFLOAT *su_window_acquire_overlap(SUSCOUNT size, SUSCOUNT overlap);
+
+void su_window_release(const void *table);
+
+void su_window_get_cache_stats(struct sigutils_window_cache_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* _SIGUTILS_WINDOW_H */
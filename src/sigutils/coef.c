@@ -38,6 +38,7 @@
 
 #define SU_LOG_DOMAIN "coef"
 
+#include <complex.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -136,7 +137,7 @@ su_trinomial_mult(int n, const SUFLOAT *b, const SUFLOAT *c)
   int i, j;
   SUFLOAT *a;
 
-  if ((a = malloc(4 * n * sizeof(SUFLOAT))) == NULL)
+  if ((a = calloc(4 * n, sizeof(SUFLOAT))) == NULL)
     return NULL;
 
   a[2] = c[0];
@@ -619,3 +620,183 @@ su_sf_bwbs(int n, SUFLOAT f1f, SUFLOAT f2f)
 
   return 1.0 / sfr;
 }
+
+/**********************************************************************
+  Second-order sections. Instead of expanding the poles of the filter
+  into a single polynomial (which is numerically fragile for high
+  orders), conjugate pole pairs are kept in separate biquads of the
+  form:
+
+    H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+
+  Each section is returned as 5 consecutive coefficients (b0, b1, b2,
+  a1, a2) and is scaled to unity gain where the filter response has its
+  maximum. Real poles (odd orders) are kept in first-order sections
+  (b2 = a2 = 0).
+*/
+
+SUPRIVATE void
+su_sos_set_pole_pair(SUFLOAT *sos, double complex p)
+{
+  sos[3] = -2 * creal(p);
+  sos[4] = creal(p) * creal(p) + cimag(p) * cimag(p);
+}
+
+/* Gain of a section at z = e^(j omega), before scaling */
+SUPRIVATE SUFLOAT
+su_sos_response_mag(const SUFLOAT *sos, SUFLOAT omega)
+{
+  double complex zinv = cexp(-I * (double) omega);
+  double complex num = sos[0] + zinv * (sos[1] + zinv * sos[2]);
+  double complex den = 1 + zinv * (sos[3] + zinv * sos[4]);
+
+  return cabs(num) / cabs(den);
+}
+
+SUPRIVATE void
+su_sos_normalize(SUFLOAT *sos, SUFLOAT omega)
+{
+  SUFLOAT mag = su_sos_response_mag(sos, omega);
+
+  if (mag > SUFLOAT_THRESHOLD) {
+    sos[0] /= mag;
+    sos[1] /= mag;
+    sos[2] /= mag;
+  }
+}
+
+/*
+ * Lowpass and highpass Butterworth filters share their poles. They
+ * are arranged in (n + 1) / 2 sections.
+ */
+SUPRIVATE SUFLOAT *
+su_sos_bwlphp(int n, SUFLOAT fcf, SUBOOL highpass, unsigned int *count)
+{
+  int k;
+  SUFLOAT theta;
+  SUFLOAT st;
+  SUFLOAT ct;
+  SUFLOAT parg;
+  SUFLOAT a;
+  SUFLOAT zero = highpass ? -1 : 1;
+  SUFLOAT *sos = NULL;
+  SUFLOAT *section;
+
+  SU_ALLOCATE_MANY_CATCH(sos, 5 * ((n + 1) / 2), SUFLOAT, return NULL);
+
+  theta = M_PI * fcf;
+  st = SU_SIN(theta);
+  ct = SU_COS(theta);
+
+  for (k = 0; k < (n + 1) / 2; ++k) {
+    section = sos + 5 * k;
+    parg = M_PI * (SUFLOAT)(2 * k + 1) / (SUFLOAT)(2 * n);
+    a = 1.0 + st * SU_SIN(parg);
+
+    if (2 * k + 1 == n) {
+      /* Real pole */
+      section[0] = 1;
+      section[1] = zero;
+      section[3] = -ct / a;
+    } else {
+      section[0] = 1;
+      section[1] = 2 * zero;
+      section[2] = 1;
+      su_sos_set_pole_pair(
+          section,
+          ct / a + I * (double) (st * SU_COS(parg) / a));
+    }
+
+    su_sos_normalize(section, highpass ? M_PI : 0);
+  }
+
+  *count = (n + 1) / 2;
+
+  return sos;
+}
+
+SUFLOAT *
+su_sos_bwlp(int n, SUFLOAT fcf, unsigned int *count)
+{
+  return su_sos_bwlphp(n, fcf, SU_FALSE, count);
+}
+
+SUFLOAT *
+su_sos_bwhp(int n, SUFLOAT fcf, unsigned int *count)
+{
+  return su_sos_bwlphp(n, fcf, SU_TRUE, count);
+}
+
+/*
+ * Bandpass filters of order 2n have n sections. Every trinomial of
+ * su_dcof_bwbp holds two poles, whose conjugates belong to the trinomial
+ * at the opposite end of the list.
+ */
+SUFLOAT *
+su_sos_bwbp(int n, SUFLOAT f1f, SUFLOAT f2f, unsigned int *count)
+{
+  int k;
+  SUFLOAT theta;
+  SUFLOAT cp;
+  SUFLOAT st;
+  SUFLOAT ct;
+  SUFLOAT s2t;
+  SUFLOAT c2t;
+  SUFLOAT parg;
+  SUFLOAT sparg;
+  SUFLOAT cparg;
+  SUFLOAT a;
+  SUFLOAT omega0;
+  double complex t, r, d;
+  SUFLOAT *sos = NULL;
+  SUFLOAT *section;
+  unsigned int p = 0;
+
+  cp = SU_COS(M_PI * (f2f + f1f) / 2.0);
+  theta = M_PI * (f2f - f1f) / 2.0;
+  st = SU_SIN(theta);
+  ct = SU_COS(theta);
+  s2t = 2.0 * st * ct;
+  c2t = 2.0 * ct * ct - 1.0;
+  omega0 = SU_ACOS(cp); /* Center of the passband */
+
+  SU_ALLOCATE_MANY_CATCH(sos, 5 * n, SUFLOAT, return NULL);
+
+  for (k = 0; k < (n + 1) / 2; ++k) {
+    parg = M_PI * (SUFLOAT)(2 * k + 1) / (SUFLOAT)(2 * n);
+    sparg = SU_SIN(parg);
+    cparg = SU_COS(parg);
+    a = 1.0 + s2t * sparg;
+
+    t = -2.0 * cp * (ct + st * sparg) / a
+        + I * (double) (-2.0 * cp * st * cparg / a);
+    r = c2t / a + I * (double) (s2t * cparg / a);
+
+    if (2 * k + 1 == n) {
+      /* Real trinomial: this is already a biquad */
+      section = sos + 5 * p++;
+      section[3] = creal(t);
+      section[4] = creal(r);
+    } else {
+      d = csqrt(t * t - 4 * r);
+
+      section = sos + 5 * p++;
+      su_sos_set_pole_pair(section, (-t + d) / 2);
+
+      section = sos + 5 * p++;
+      su_sos_set_pole_pair(section, (-t - d) / 2);
+    }
+  }
+
+  for (k = 0; k < n; ++k) {
+    section = sos + 5 * k;
+    section[0] = 1;
+    section[1] = 0;
+    section[2] = -1;
+    su_sos_normalize(section, omega0);
+  }
+
+  *count = n;
+
+  return sos;
+}
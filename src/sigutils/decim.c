@@ -0,0 +1,162 @@
+/*
+
+  Copyright (C) 2026 Gonzalo José Carracedo Carballal
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, version 3.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this program.  If not, see
+  <http://www.gnu.org/licenses/>
+
+*/
+
+#define SU_LOG_DOMAIN "decim"
+
+#include <sigutils/decim.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <sigutils/design.h>
+#include <sigutils/log.h>
+
+SU_CONSTRUCTOR(
+    su_decim,
+    unsigned int decimation,
+    const SUFLOAT *h,
+    unsigned int taps)
+{
+  unsigned int i;
+
+  memset(self, 0, sizeof(su_decim_t));
+
+  SU_TRYCATCH(decimation > 0, goto fail);
+  SU_TRYCATCH(taps > 0, goto fail);
+
+  self->decimation = decimation;
+  self->taps = taps;
+
+  SU_ALLOCATE_MANY_FAIL(self->h, taps, SUFLOAT);
+  SU_ALLOCATE_MANY_FAIL(self->history, 2 * taps, SUCOMPLEX);
+
+  /* Stored in reverse order, so they can be applied to the history as is */
+  for (i = 0; i < taps; ++i)
+    self->h[i] = h[taps - 1 - i];
+
+  return SU_TRUE;
+
+fail:
+  SU_DESTRUCT(su_decim, self);
+
+  return SU_FALSE;
+}
+
+SU_METHOD(
+    su_decim,
+    SUBOOL,
+    init_lowpass,
+    unsigned int decimation,
+    unsigned int taps_per_phase,
+    SUFLOAT fc)
+{
+  const SUFLOAT *h = NULL;
+  SUFLOAT sum = 0;
+  unsigned int taps = taps_per_phase * decimation;
+  unsigned int i;
+  SUBOOL ok = SU_FALSE;
+
+  SU_TRYCATCH(taps > 0, goto done);
+
+  SU_TRY(h = su_design_brickwall_lp(fc, taps));
+
+  SU_TRY(su_decim_init(self, decimation, h, taps));
+
+  /* Unity gain in the passband */
+  for (i = 0; i < taps; ++i)
+    sum += h[i];
+
+  for (i = 0; i < taps; ++i)
+    self->h[i] /= sum;
+
+  ok = SU_TRUE;
+
+done:
+  su_design_release(h);
+
+  return ok;
+}
+
+SU_DESTRUCTOR(su_decim)
+{
+  if (self->h != NULL)
+    free(self->h);
+
+  if (self->history != NULL)
+    free(self->history);
+
+  memset(self, 0, sizeof(su_decim_t));
+}
+
+SU_METHOD(su_decim, void, reset)
+{
+  memset(self->history, 0, 2 * self->taps * sizeof(SUCOMPLEX));
+
+  self->p = 0;
+  self->fill = 0;
+}
+
+SUINLINE SUCOMPLEX
+__su_decim_eval(const su_decim_t *self)
+{
+  const SUCOMPLEX *x = self->history + self->p; /* x[taps - 1] is newest */
+  const SUFLOAT *h = self->h;
+  unsigned int L = self->taps;
+  unsigned int l;
+  SUCOMPLEX acc = 0;
+
+  for (l = 0; l < L; ++l)
+    acc += h[l] * x[l];
+
+  return acc;
+}
+
+SU_METHOD(
+    su_decim,
+    SUSCOUNT,
+    feed_bulk,
+    const SUCOMPLEX *__restrict in,
+    SUSCOUNT size,
+    SUCOMPLEX *__restrict out)
+{
+  SUCOMPLEX *history = self->history;
+  unsigned int L = self->taps;
+  unsigned int p = self->p;
+  unsigned int fill = self->fill;
+  SUSCOUNT n = 0;
+  SUSCOUNT i;
+
+  for (i = 0; i < size; ++i) {
+    history[p] = history[p + L] = in[i];
+
+    if (++p == L)
+      p = 0;
+
+    if (++fill == self->decimation) {
+      fill = 0;
+      self->p = p;
+      out[n++] = __su_decim_eval(self);
+    }
+  }
+
+  self->p = p;
+  self->fill = fill;
+
+  return n;
+}
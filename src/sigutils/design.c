@@ -0,0 +1,360 @@
+/*
+
+  Copyright (C) 2026 Gonzalo José Carracedo Carballal
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, version 3.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this program.  If not, see
+  <http://www.gnu.org/licenses/>
+
+*/
+
+#define SU_LOG_DOMAIN "design"
+
+#include <sigutils/design.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <sigutils/coef.h>
+#include <sigutils/log.h>
+#include <sigutils/refcache.h>
+#include <sigutils/taps.h>
+
+enum sigutils_design_kind {
+  SU_DESIGN_KIND_DCOF_BWLP,
+  SU_DESIGN_KIND_CCOF_BWLP,
+  SU_DESIGN_KIND_SF_BWLP,
+  SU_DESIGN_KIND_SOS_BWLP,
+  SU_DESIGN_KIND_SOS_BWHP,
+  SU_DESIGN_KIND_SOS_BWBP,
+  SU_DESIGN_KIND_RRC,
+  SU_DESIGN_KIND_BRICKWALL_LP,
+  SU_DESIGN_KIND_BRICKWALL_BP
+};
+
+struct sigutils_design_cache_entry {
+  struct sigutils_refcache_entry header; /* data: coef, size: coefficients */
+
+  enum sigutils_design_kind kind;
+  SUSCOUNT n;
+  SUFLOAT  p1;
+  SUFLOAT  p2;
+
+  SUFLOAT     *coef;
+  unsigned int count; /* Number of sections, for SOS designs */
+};
+
+/* Computes the coefficients described by the key of entry */
+SUPRIVATE SUBOOL
+su_design_cache_entry_compute(struct sigutils_design_cache_entry *entry)
+{
+  SUBOOL ok = SU_FALSE;
+  int n = entry->n;
+
+  switch (entry->kind) {
+    case SU_DESIGN_KIND_DCOF_BWLP:
+      SU_TRY(entry->coef = su_dcof_bwlp(n, entry->p1));
+      entry->header.size = n + 1;
+      break;
+
+    case SU_DESIGN_KIND_CCOF_BWLP:
+      SU_TRY(entry->coef = su_ccof_bwlp(n));
+      entry->header.size = n + 1;
+      break;
+
+    case SU_DESIGN_KIND_SF_BWLP:
+      SU_ALLOCATE(entry->coef, SUFLOAT);
+      entry->coef[0] = su_sf_bwlp(n, entry->p1);
+      entry->header.size = 1;
+      break;
+
+    case SU_DESIGN_KIND_SOS_BWLP:
+      SU_TRY(entry->coef = su_sos_bwlp(n, entry->p1, &entry->count));
+      entry->header.size = 5 * entry->count;
+      break;
+
+    case SU_DESIGN_KIND_SOS_BWHP:
+      SU_TRY(entry->coef = su_sos_bwhp(n, entry->p1, &entry->count));
+      entry->header.size = 5 * entry->count;
+      break;
+
+    case SU_DESIGN_KIND_SOS_BWBP:
+      SU_TRY(
+          entry->coef =
+              su_sos_bwbp(n, entry->p1, entry->p2, &entry->count));
+      entry->header.size = 5 * entry->count;
+      break;
+
+    case SU_DESIGN_KIND_RRC:
+      SU_ALLOCATE_MANY(entry->coef, entry->n, SUFLOAT);
+      su_taps_rrc_init(entry->coef, entry->p1, entry->p2, entry->n);
+      entry->header.size = entry->n;
+      break;
+
+    case SU_DESIGN_KIND_BRICKWALL_LP:
+      SU_ALLOCATE_MANY(entry->coef, entry->n, SUFLOAT);
+      su_taps_brickwall_lp_init(entry->coef, entry->p1, entry->n);
+      entry->header.size = entry->n;
+      break;
+
+    case SU_DESIGN_KIND_BRICKWALL_BP:
+      SU_ALLOCATE_MANY(entry->coef, entry->n, SUFLOAT);
+      su_taps_brickwall_bp_init(
+          entry->coef,
+          entry->p1,
+          entry->p2,
+          entry->n);
+      entry->header.size = entry->n;
+      break;
+  }
+
+  ok = entry->coef != NULL;
+
+done:
+  return ok;
+}
+
+SUPRIVATE SUBOOL
+su_design_cache_entry_match(
+    const struct sigutils_refcache_entry *header,
+    const void *key)
+{
+  const struct sigutils_design_cache_entry *entry =
+      (const struct sigutils_design_cache_entry *)header;
+  const struct sigutils_design_cache_entry *k =
+      (const struct sigutils_design_cache_entry *)key;
+
+  return entry->kind == k->kind
+      && entry->n    == k->n
+      && entry->p1   == k->p1
+      && entry->p2   == k->p2;
+}
+
+SUPRIVATE void
+su_design_cache_entry_destroy(struct sigutils_refcache_entry *header)
+{
+  struct sigutils_design_cache_entry *entry =
+      (struct sigutils_design_cache_entry *)header;
+
+  if (entry->coef != NULL)
+    free(entry->coef);
+
+  free(entry);
+}
+
+SUPRIVATE struct sigutils_refcache_entry *
+su_design_cache_entry_create(const void *key)
+{
+  struct sigutils_design_cache_entry *entry = NULL;
+
+  SU_ALLOCATE(entry, struct sigutils_design_cache_entry);
+  *entry = *(const struct sigutils_design_cache_entry *)key;
+
+  SU_TRY(su_design_cache_entry_compute(entry));
+
+  entry->header.data = entry->coef;
+
+  return &entry->header;
+
+done:
+  if (entry != NULL)
+    su_design_cache_entry_destroy(&entry->header);
+
+  return NULL;
+}
+
+SUPRIVATE const struct sigutils_refcache_class g_design_cache_class = {
+    su_design_cache_entry_match,
+    su_design_cache_entry_create,
+    su_design_cache_entry_destroy,
+    SU_DESIGN_CACHE_MAX_IDLE,
+    SU_DESIGN_CACHE_MAX_IDLE_SIZE};
+
+SUPRIVATE su_refcache_t g_design_cache =
+    su_refcache_INITIALIZER(&g_design_cache_class);
+
+/* Looks up a design matching key, computing it if necessary */
+SUPRIVATE const SUFLOAT *
+su_design_acquire(
+    const struct sigutils_design_cache_entry *key,
+    unsigned int *count)
+{
+  const struct sigutils_design_cache_entry *entry;
+
+  entry = (const struct sigutils_design_cache_entry *)su_refcache_acquire(
+      &g_design_cache,
+      key);
+  if (entry == NULL)
+    return NULL;
+
+  if (count != NULL)
+    *count = entry->count;
+
+  return entry->coef;
+}
+
+SUINLINE void
+su_design_key_init(
+    struct sigutils_design_cache_entry *key,
+    enum sigutils_design_kind kind,
+    SUSCOUNT n,
+    SUFLOAT p1,
+    SUFLOAT p2)
+{
+  memset(key, 0, sizeof(struct sigutils_design_cache_entry));
+
+  key->kind = kind;
+  key->n    = n;
+  key->p1   = p1;
+  key->p2   = p2;
+}
+
+/* Denominator coefficients (n + 1) */
+const SUFLOAT *
+su_design_dcof_bwlp(int n, SUFLOAT fcf)
+{
+  struct sigutils_design_cache_entry key;
+
+  SU_TRYCATCH(n > 0, return NULL);
+
+  su_design_key_init(&key, SU_DESIGN_KIND_DCOF_BWLP, n, fcf, 0);
+
+  return su_design_acquire(&key, NULL);
+}
+
+/* Numerator coefficients (n + 1), not scaled */
+const SUFLOAT *
+su_design_ccof_bwlp(int n)
+{
+  struct sigutils_design_cache_entry key;
+
+  SU_TRYCATCH(n > 0, return NULL);
+
+  su_design_key_init(&key, SU_DESIGN_KIND_CCOF_BWLP, n, 0, 0);
+
+  return su_design_acquire(&key, NULL);
+}
+
+SUFLOAT
+su_design_sf_bwlp(int n, SUFLOAT fcf)
+{
+  struct sigutils_design_cache_entry key;
+  const SUFLOAT *sf;
+  SUFLOAT result;
+
+  su_design_key_init(&key, SU_DESIGN_KIND_SF_BWLP, n, fcf, 0);
+
+  if ((sf = su_design_acquire(&key, NULL)) == NULL)
+    return su_sf_bwlp(n, fcf);
+
+  result = *sf;
+
+  su_design_release(sf);
+
+  return result;
+}
+
+const SUFLOAT *
+su_design_sos_bwlp(int n, SUFLOAT fcf, unsigned int *count)
+{
+  struct sigutils_design_cache_entry key;
+
+  SU_TRYCATCH(n > 0, return NULL);
+
+  su_design_key_init(&key, SU_DESIGN_KIND_SOS_BWLP, n, fcf, 0);
+
+  return su_design_acquire(&key, count);
+}
+
+const SUFLOAT *
+su_design_sos_bwhp(int n, SUFLOAT fcf, unsigned int *count)
+{
+  struct sigutils_design_cache_entry key;
+
+  SU_TRYCATCH(n > 0, return NULL);
+
+  su_design_key_init(&key, SU_DESIGN_KIND_SOS_BWHP, n, fcf, 0);
+
+  return su_design_acquire(&key, count);
+}
+
+const SUFLOAT *
+su_design_sos_bwbp(int n, SUFLOAT f1f, SUFLOAT f2f, unsigned int *count)
+{
+  struct sigutils_design_cache_entry key;
+
+  SU_TRYCATCH(n > 0, return NULL);
+
+  su_design_key_init(&key, SU_DESIGN_KIND_SOS_BWBP, n, f1f, f2f);
+
+  return su_design_acquire(&key, count);
+}
+
+const SUFLOAT *
+su_design_rrc(SUFLOAT T, SUFLOAT beta, SUSCOUNT size)
+{
+  struct sigutils_design_cache_entry key;
+
+  SU_TRYCATCH(size > 0, return NULL);
+
+  su_design_key_init(&key, SU_DESIGN_KIND_RRC, size, T, beta);
+
+  return su_design_acquire(&key, NULL);
+}
+
+const SUFLOAT *
+su_design_brickwall_lp(SUFLOAT fc, SUSCOUNT size)
+{
+  struct sigutils_design_cache_entry key;
+
+  SU_TRYCATCH(size > 0, return NULL);
+
+  su_design_key_init(&key, SU_DESIGN_KIND_BRICKWALL_LP, size, fc, 0);
+
+  return su_design_acquire(&key, NULL);
+}
+
+const SUFLOAT *
+su_design_brickwall_bp(SUFLOAT bw, SUFLOAT if_nor, SUSCOUNT size)
+{
+  struct sigutils_design_cache_entry key;
+
+  SU_TRYCATCH(size > 0, return NULL);
+
+  su_design_key_init(&key, SU_DESIGN_KIND_BRICKWALL_BP, size, bw, if_nor);
+
+  return su_design_acquire(&key, NULL);
+}
+
+void
+su_design_release(const SUFLOAT *coef)
+{
+  if (coef == NULL)
+    return;
+
+  if (!su_refcache_release(&g_design_cache, coef))
+    SU_WARNING("Releasing coefficients that do not belong to the cache\n");
+}
+
+void
+su_design_get_cache_stats(struct sigutils_design_cache_stats *stats)
+{
+  struct sigutils_refcache_stats cache_stats;
+
+  su_refcache_get_stats(&g_design_cache, &cache_stats);
+
+  stats->hits    = cache_stats.hits;
+  stats->misses  = cache_stats.misses;
+  stats->entries = cache_stats.entries;
+  stats->idle    = cache_stats.idle;
+  stats->size    = cache_stats.size;
+}
@@ -23,7 +23,6 @@
 
 #include <assert.h>
 #include <sigutils/sampling.h>
-#include <sigutils/taps.h>
 
 SU_CONSTRUCTOR(su_peak_detector, unsigned int size, SUFLOAT thres)
 {
@@ -166,24 +165,22 @@ SU_METHOD(su_channel_detector, void, channel_list_clear)
   FOR_EACH_PTR(chan, self, channel)
   SU_DISPOSE(su_channel, chan);
 
-  if (self->channel_list != NULL)
-    free(self->channel_list);
-
-  self->channel_count = 0;
-  self->channel_list = NULL;
+  PTR_SLOTMAP_FINALIZE(self->channel);
 }
 
 SUPRIVATE
 SU_METHOD(su_channel_detector, void, channel_collect)
 {
-  unsigned int i;
-
-  for (i = 0; i < self->channel_count; ++i)
-    if (self->channel_list[i] != NULL)
-      if (self->channel_list[i]->age++ > 2 * self->channel_list[i]->present) {
-        su_channel_destroy(self->channel_list[i]);
-        self->channel_list[i] = NULL;
-      }
+  unsigned int i = 0;
+
+  /* Removing a channel moves the last one to its place */
+  while (i < self->channel_count)
+    if (self->channel_list[i]->age++ > 2 * self->channel_list[i]->present) {
+      su_channel_destroy(self->channel_list[i]);
+      PTR_SLOTMAP_REMOVE_AT(self->channel, i);
+    } else {
+      ++i;
+    }
 }
 
 SU_GETTER(su_channel_detector, su_channel_t *, lookup_channel, SUFLOAT fc)
@@ -226,7 +223,7 @@ su_channel_detector_assert_channel(
     owned->f_lo = new->f_lo;
     owned->f_hi = new->f_hi;
 
-    SU_TRYC(PTR_LIST_APPEND_CHECK(self->channel, owned));
+    SU_TRYC(PTR_SLOTMAP_INSERT(self->channel, owned));
 
     chan = owned;
     owned = NULL;
@@ -259,16 +256,16 @@ done:
 SU_COLLECTOR(su_channel_detector)
 {
   if (self->fft_plan != NULL)
-    SU_FFTW(_destroy_plan)(self->fft_plan);
+    su_lib_release_plan(self->fft_plan);
 
   if (self->fft_plan_rev != NULL)
-    SU_FFTW(_destroy_plan)(self->fft_plan_rev);
+    su_lib_release_plan(self->fft_plan_rev);
 
   if (self->window != NULL)
     SU_FFTW(_free)(self->window);
 
-  if (self->window_func != NULL)
-    SU_FFTW(_free)(self->window_func);
+  su_window_release(self->window_func);
+  su_window_release(self->nl_window);
 
   if (self->fft != NULL)
     SU_FFTW(_free)(self->fft);
@@ -353,53 +350,6 @@ SU_METHOD(
   return SU_TRUE;
 }
 
-SUINLINE
-SU_METHOD(su_channel_detector, SUBOOL, init_window_func)
-{
-  unsigned int i;
-
-  for (i = 0; i < self->params.window_size; ++i)
-    self->window_func[i] = 1;
-
-  switch (self->params.window) {
-    case SU_CHANNEL_DETECTOR_WINDOW_NONE:
-      /* Do nothing. */
-      break;
-
-    case SU_CHANNEL_DETECTOR_WINDOW_HAMMING:
-      su_taps_apply_hamming_complex(
-          self->window_func,
-          self->params.window_size);
-      break;
-
-    case SU_CHANNEL_DETECTOR_WINDOW_HANN:
-      su_taps_apply_hann_complex(self->window_func, self->params.window_size);
-      break;
-
-    case SU_CHANNEL_DETECTOR_WINDOW_FLAT_TOP:
-      su_taps_apply_flat_top_complex(
-          self->window_func,
-          self->params.window_size);
-      break;
-
-    case SU_CHANNEL_DETECTOR_WINDOW_BLACKMANN_HARRIS:
-      su_taps_apply_blackmann_harris_complex(
-          self->window_func,
-          self->params.window_size);
-      break;
-
-    default:
-      /*
-       * This surely will generate thousands of messages, but it should
-       * never happen either
-       */
-      SU_WARNING("Unsupported window function %d\n", self->params.window);
-      return SU_FALSE;
-  }
-
-  return SU_TRUE;
-}
-
 SU_INSTANCER(
     su_channel_detector,
     const struct sigutils_channel_detector_params *params)
@@ -426,14 +376,11 @@ SU_INSTANCER(
 
   memset(new->window, 0, params->window_size * sizeof(SU_FFTW(_complex)));
 
-  if ((new->window_func =
-           SU_FFTW(_malloc)(params->window_size * sizeof(SU_FFTW(_complex))))
-      == NULL) {
-    SU_ERROR("cannot allocate memory for window function\n");
-    goto fail;
-  }
-
-  SU_TRYCATCH(su_channel_detector_init_window_func(new), goto fail);
+  SU_TRYCATCH(
+      new->window_func = su_window_acquire_complex(
+          (enum sigutils_window_kind)params->window,
+          params->window_size),
+      goto fail);
 
   if ((new->fft =
            SU_FFTW(_malloc)(params->window_size * sizeof(SU_FFTW(_complex))))
@@ -451,8 +398,9 @@ SU_INSTANCER(
   SU_ALLOCATE_MANY_FAIL(new->_r_alloc, params->window_size, SUFLOAT);
 
   /* Direct FFT plan */
-  if ((new->fft_plan = su_lib_plan_dft_1d(
+  if ((new->fft_plan = su_lib_acquire_dft_plan(
            params->window_size,
+           1,
            new->window,
            new->fft,
            FFTW_FORWARD,
@@ -492,8 +440,9 @@ SU_INSTANCER(
 
       memset(new->ifft, 0, params->window_size * sizeof(SU_FFTW(_complex)));
 
-      if ((new->fft_plan_rev = su_lib_plan_dft_1d(
+      if ((new->fft_plan_rev = su_lib_acquire_dft_plan(
                params->window_size,
+               1,
                new->fft,
                new->ifft,
                FFTW_BACKWARD,
@@ -984,7 +933,7 @@ SU_METHOD(su_channel_detector, SUBOOL, exec_fft)
       /* Spectrum mode only */
       ++self->iters;
       su_channel_detector_apply_window(self);
-      SU_FFTW(_execute(self->fft_plan));
+      SU_FFTW(_execute_dft(self->fft_plan, self->window, self->fft));
 
       for (i = 0; i < self->params.window_size; ++i)
         self->spect[i] =
@@ -998,7 +947,7 @@ SU_METHOD(su_channel_detector, SUBOOL, exec_fft)
        */
       su_channel_detector_apply_window(self);
 
-      SU_FFTW(_execute(self->fft_plan));
+      SU_FFTW(_execute_dft(self->fft_plan, self->window, self->fft));
 
       self->dc += SU_CHANNEL_DETECTOR_DC_ALPHA
                   * (self->fft[0] / self->params.window_size - self->dc);
@@ -1019,10 +968,10 @@ SU_METHOD(su_channel_detector, SUBOOL, exec_fft)
        */
 
       /* Don't apply *any* window function */
-      SU_FFTW(_execute(self->fft_plan));
+      SU_FFTW(_execute_dft(self->fft_plan, self->window, self->fft));
       for (i = 0; i < self->params.window_size; ++i)
         self->fft[i] *= SU_C_CONJ(self->fft[i]);
-      SU_FFTW(_execute(self->fft_plan_rev));
+      SU_FFTW(_execute_dft(self->fft_plan_rev, self->fft, self->ifft));
 
       /* Average result */
       for (i = 0; i < self->params.window_size; ++i) {
@@ -1039,11 +988,17 @@ SU_METHOD(su_channel_detector, SUBOOL, exec_fft)
        * of the signal. This will introduce a train of pulses on every
        * non-equal symbol transition.
        */
-      su_taps_apply_blackmann_harris_complex(
-          self->window,
-          self->params.window_size);
+      if (self->nl_window == NULL)
+        SU_TRYCATCH(
+            self->nl_window = su_window_acquire(
+                SU_WINDOW_BLACKMANN_HARRIS,
+                self->params.window_size),
+            return SU_FALSE);
+
+      for (i = 0; i < self->params.window_size; ++i)
+        self->window[i] *= self->nl_window[i];
 
-      SU_FFTW(_execute(self->fft_plan));
+      SU_FFTW(_execute_dft(self->fft_plan, self->window, self->fft));
 
       for (i = 0; i < self->params.window_size; ++i) {
         psd = SU_C_REAL(self->fft[i] * SU_C_CONJ(self->fft[i]));
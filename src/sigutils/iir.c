@@ -20,11 +20,13 @@
 #include <sigutils/iir.h>
 
 #include <assert.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 
-#include <sigutils/coef.h>
+#include <sigutils/design.h>
 #include <sigutils/sampling.h>
+#include <sigutils/sigutils.h>
 #include <sigutils/taps.h>
 
 /*
@@ -150,13 +152,484 @@ __su_iir_filt_eval(const su_iir_filt_t *filt)
   return y;
 }
 
+/************************* Second order sections *****************************/
+SUINLINE SUCOMPLEX
+__su_iir_sos_step(const SUFLOAT *c, SUCOMPLEX *s, SUCOMPLEX x)
+{
+  SUCOMPLEX y = c[0] * x + s[0];
+
+  s[0] = c[1] * x - c[3] * y + s[1];
+  s[1] = c[2] * x - c[4] * y;
+
+  return y;
+}
+
+SUINLINE SUCOMPLEX
+__su_iir_sos_feed(su_iir_filt_t *filt, SUCOMPLEX x)
+{
+  unsigned int i;
+
+  for (i = 0; i < filt->sos_count; ++i)
+    x = __su_iir_sos_step(filt->sos + 5 * i, filt->sos_state + 2 * i, x);
+
+  return x;
+}
+
+/* Runs a section over a whole block, in place */
+SUPRIVATE void
+__su_iir_sos_run_single(
+    const SUFLOAT *c,
+    SUCOMPLEX *state,
+    SUCOMPLEX *buf,
+    SUSCOUNT len)
+{
+  SUFLOAT b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+  SUCOMPLEX s1 = state[0], s2 = state[1];
+  SUCOMPLEX x, y;
+  SUSCOUNT i;
+
+  for (i = 0; i < len; ++i) {
+    x = buf[i];
+    y = b0 * x + s1;
+    s1 = b1 * x - a1 * y + s2;
+    s2 = b2 * x - a2 * y;
+    buf[i] = y;
+  }
+
+  state[0] = s1;
+  state[1] = s2;
+}
+
+/*
+ * Two consecutive sections are run together, with the second one lagging
+ * one sample behind the first. The real and imaginary parts of both
+ * sections are then four independent lanes performing the same
+ * arithmetic, which the compiler can map to a single SIMD register.
+ */
+#define SU_IIR_SOS_LANES 4
+
+struct su_iir_sos_lanes {
+  SUFLOAT b0[SU_IIR_SOS_LANES];
+  SUFLOAT b1[SU_IIR_SOS_LANES];
+  SUFLOAT b2[SU_IIR_SOS_LANES];
+  SUFLOAT a1[SU_IIR_SOS_LANES];
+  SUFLOAT a2[SU_IIR_SOS_LANES];
+  SUFLOAT s1[SU_IIR_SOS_LANES];
+  SUFLOAT s2[SU_IIR_SOS_LANES];
+  SUFLOAT x[SU_IIR_SOS_LANES];
+  SUFLOAT y[SU_IIR_SOS_LANES];
+};
+
+SUINLINE void
+__su_iir_sos_lanes_step(
+    struct su_iir_sos_lanes *l,
+    unsigned int from,
+    unsigned int to)
+{
+  unsigned int j;
+
+  for (j = from; j < to; ++j) {
+    l->y[j] = l->b0[j] * l->x[j] + l->s1[j];
+    l->s1[j] = l->b1[j] * l->x[j] - l->a1[j] * l->y[j] + l->s2[j];
+    l->s2[j] = l->b2[j] * l->x[j] - l->a2[j] * l->y[j];
+  }
+}
+
+SUPRIVATE void
+__su_iir_sos_run_pair(
+    const SUFLOAT *c,
+    SUCOMPLEX *state,
+    SUCOMPLEX *buf,
+    SUSCOUNT len)
+{
+  struct su_iir_sos_lanes l;
+  const SUFLOAT *cj;
+  SUSCOUNT n;
+  unsigned int j;
+
+  for (j = 0; j < SU_IIR_SOS_LANES; ++j) {
+    cj = c + 5 * (j >> 1);
+    l.b0[j] = cj[0];
+    l.b1[j] = cj[1];
+    l.b2[j] = cj[2];
+    l.a1[j] = cj[3];
+    l.a2[j] = cj[4];
+  }
+
+  for (j = 0; j < 2; ++j) {
+    l.s1[2 * j] = SU_C_REAL(state[2 * j]);
+    l.s1[2 * j + 1] = SU_C_IMAG(state[2 * j]);
+    l.s2[2 * j] = SU_C_REAL(state[2 * j + 1]);
+    l.s2[2 * j + 1] = SU_C_IMAG(state[2 * j + 1]);
+  }
+
+  /* First sample: first section only */
+  l.x[0] = SU_C_REAL(buf[0]);
+  l.x[1] = SU_C_IMAG(buf[0]);
+  __su_iir_sos_lanes_step(&l, 0, 2);
+
+  for (n = 1; n < len; ++n) {
+    l.x[0] = SU_C_REAL(buf[n]);
+    l.x[1] = SU_C_IMAG(buf[n]);
+    l.x[2] = l.y[0];
+    l.x[3] = l.y[1];
+
+    __su_iir_sos_lanes_step(&l, 0, SU_IIR_SOS_LANES);
+
+    buf[n - 1] = l.y[2] + I * l.y[3];
+  }
+
+  /* Last sample: second section only */
+  l.x[2] = l.y[0];
+  l.x[3] = l.y[1];
+  __su_iir_sos_lanes_step(&l, 2, SU_IIR_SOS_LANES);
+
+  buf[len - 1] = l.y[2] + I * l.y[3];
+
+  for (j = 0; j < 2; ++j) {
+    state[2 * j] = l.s1[2 * j] + I * l.s1[2 * j + 1];
+    state[2 * j + 1] = l.s2[2 * j] + I * l.s2[2 * j + 1];
+  }
+}
+
+SUPRIVATE void
+__su_iir_sos_feed_bulk(su_iir_filt_t *filt, SUCOMPLEX *buf, SUSCOUNT len)
+{
+  unsigned int i;
+
+  for (i = 0; i + 1 < filt->sos_count; i += 2)
+    __su_iir_sos_run_pair(
+        filt->sos + 5 * i,
+        filt->sos_state + 2 * i,
+        buf,
+        len);
+
+  if (i < filt->sos_count)
+    __su_iir_sos_run_single(
+        filt->sos + 5 * i,
+        filt->sos_state + 2 * i,
+        buf,
+        len);
+}
+
+/************************** Direct form, in blocks **************************/
+/*
+ * Copies the last count samples of a history buffer (x or y, count less
+ * than its size) to dest, in chronological order
+ */
+SUINLINE void
+__su_iir_filt_get_history(
+    const SUCOMPLEX *buf,
+    unsigned int size,
+    int ptr,
+    SUCOMPLEX *dest,
+    unsigned int count)
+{
+#ifdef SU_USE_VOLK
+  unsigned int i;
+
+  /* Newest sample first, contiguous */
+  for (i = 0; i < count; ++i)
+    dest[i] = buf[ptr + count - 1 - i];
+#else
+  unsigned int p = ptr + size - count;
+
+  /* Oldest sample at ptr */
+  if (p >= size)
+    p -= size;
+
+  if (p + count <= size) {
+    memcpy(dest, buf + p, count * sizeof(SUCOMPLEX));
+  } else {
+    memcpy(dest, buf + p, (size - p) * sizeof(SUCOMPLEX));
+    memcpy(dest + size - p, buf, (count - size + p) * sizeof(SUCOMPLEX));
+  }
+#endif /* SU_USE_VOLK */
+}
+
+/*
+ * Recursive part of low order filters, with the previous outputs kept in
+ * locals. Unused coefficients are zero, so the same loop serves all
+ * orders up to SU_IIR_REGISTER_FEEDBACK.
+ */
+#define SU_IIR_REGISTER_FEEDBACK 4
+
+SUINLINE void
+__su_iir_filt_feedback_registers(
+    const SUFLOAT *a,
+    SUCOMPLEX *y,
+    unsigned int order,
+    SUSCOUNT len)
+{
+  SUFLOAT a1 = order > 0 ? a[1] : 0;
+  SUFLOAT a2 = order > 1 ? a[2] : 0;
+  SUFLOAT a3 = order > 2 ? a[3] : 0;
+  SUFLOAT a4 = order > 3 ? a[4] : 0;
+  SUCOMPLEX y1 = order > 0 ? y[-1] : 0;
+  SUCOMPLEX y2 = order > 1 ? y[-2] : 0;
+  SUCOMPLEX y3 = order > 2 ? y[-3] : 0;
+  SUCOMPLEX y4 = order > 3 ? y[-4] : 0;
+  SUCOMPLEX acc;
+  SUSCOUNT n;
+
+  if (order <= 2) {
+    for (n = 0; n < len; ++n) {
+      acc = y[n] - a1 * y1 - a2 * y2;
+      y2 = y1;
+      y1 = acc;
+      y[n] = acc;
+    }
+  } else {
+    for (n = 0; n < len; ++n) {
+      acc = y[n] - a1 * y1 - a2 * y2 - a3 * y3 - a4 * y4;
+      y4 = y3;
+      y3 = y2;
+      y2 = y1;
+      y1 = acc;
+      y[n] = acc;
+    }
+  }
+}
+
+/*
+ * Filters up to SU_IIR_BLOCK_SIZE samples with the direct form. The
+ * feedforward part is computed for the whole block first, as a
+ * correlation over the linear input history. The recursive part then
+ * runs over the linear output history.
+ */
+SUPRIVATE SUCOMPLEX
+__su_iir_filt_feed_block(
+    su_iir_filt_t *filt,
+    const SUCOMPLEX *x,
+    SUCOMPLEX *y,
+    SUSCOUNT len)
+{
+  SUCOMPLEX *__restrict xl = filt->x_lin;
+  SUCOMPLEX *__restrict out;
+  SUCOMPLEX *yl = filt->y_lin;
+  const SUFLOAT *a = filt->a;
+  const SUFLOAT *b = filt->b;
+  unsigned int xh = filt->x_size - 1;
+  unsigned int yh = filt->y_size > 0 ? filt->y_size - 1 : 0;
+  SUCOMPLEX acc, last;
+  SUFLOAT k;
+  SUSCOUNT n;
+  unsigned int i;
+
+  __su_iir_filt_get_history(filt->x, filt->x_size, filt->x_ptr, xl, xh);
+  memcpy(xl + xh, x, len * sizeof(SUCOMPLEX));
+
+  /* Update history before y (which may be x) is overwritten */
+  for (n = len > filt->x_size ? len - filt->x_size : 0; n < len; ++n)
+    __su_iir_filt_push_x(filt, x[n]);
+
+  out = filt->y_size > 0 ? yl + yh : y;
+
+  /* Feedforward part */
+  k = b[0];
+  for (n = 0; n < len; ++n)
+    out[n] = k * xl[xh + n];
+
+  for (i = 1; i <= xh; ++i) {
+    k = b[i];
+    for (n = 0; n < len; ++n)
+      out[n] += k * xl[xh + n - i];
+  }
+
+  if (filt->y_size == 0) {
+    last = y[len - 1];
+
+    for (n = 0; n < len; ++n)
+      y[n] *= filt->gain;
+
+    return last;
+  }
+
+  /* Recursive part - assumes that a[0] is 1 */
+  __su_iir_filt_get_history(filt->y, filt->y_size, filt->y_ptr, yl, yh);
+
+  if (yh <= SU_IIR_REGISTER_FEEDBACK)
+    __su_iir_filt_feedback_registers(a, yl + yh, yh, len);
+  else
+    for (n = 0; n < len; ++n) {
+      acc = yl[yh + n];
+      for (i = 1; i <= yh; ++i)
+        acc -= a[i] * yl[yh + n - i];
+      yl[yh + n] = acc;
+    }
+
+  for (n = len > filt->y_size ? len - filt->y_size : 0; n < len; ++n)
+    __su_iir_filt_push_y(filt, yl[yh + n]);
+
+  for (n = 0; n < len; ++n)
+    y[n] = filt->gain * yl[yh + n];
+
+  return yl[yh + len - 1];
+}
+
+/* Returns the last output, before gain */
+SUPRIVATE SUCOMPLEX
+__su_iir_filt_feed_direct(
+    su_iir_filt_t *filt,
+    const SUCOMPLEX *x,
+    SUCOMPLEX *y,
+    SUSCOUNT len)
+{
+  SUCOMPLEX last = filt->curr_y;
+  SUSCOUNT chunk;
+
+  while (len > 0) {
+    chunk = SU_MIN(len, SU_IIR_BLOCK_SIZE);
+    last = __su_iir_filt_feed_block(filt, x, y, chunk);
+
+    x += chunk;
+    y += chunk;
+    len -= chunk;
+  }
+
+  return last;
+}
+
+/************************** Overlap-save FIR engine **************************/
+/*
+ * Filters up to ols_block samples with a single pair of FFTs. The last
+ * x_size - 1 inputs are placed before the new ones, so the circular
+ * wrap of the convolution only affects the outputs we discard.
+ */
+SUPRIVATE SUCOMPLEX
+__su_iir_ols_feed_block(
+    su_iir_filt_t *filt,
+    const SUCOMPLEX *x,
+    SUCOMPLEX *y,
+    SUSCOUNT len)
+{
+  SUCOMPLEX *buf = filt->ols_buf;
+  const SUCOMPLEX *h = filt->ols_h;
+  unsigned int hist = filt->x_size - 1;
+  SUSCOUNT i;
+
+  __su_iir_filt_get_history(filt->x, filt->x_size, filt->x_ptr, buf, hist);
+  memcpy(buf + hist, x, len * sizeof(SUCOMPLEX));
+
+  /*
+   * Short blocks: the samples after the new ones do not contribute to
+   * the outputs we keep, but their rounding errors do. Clear them.
+   */
+  memset(
+      buf + hist + len,
+      0,
+      (filt->ols_size - hist - len) * sizeof(SUCOMPLEX));
+
+  /* Update history before y (which may be x) is overwritten */
+  for (i = len > filt->x_size ? len - filt->x_size : 0; i < len; ++i)
+    __su_iir_filt_push_x(filt, x[i]);
+
+  SU_FFTW(_execute_dft)(filt->ols_forward, buf, buf);
+
+  for (i = 0; i < filt->ols_size; ++i)
+    buf[i] *= h[i];
+
+  SU_FFTW(_execute_dft)(filt->ols_backward, buf, buf);
+
+  for (i = 0; i < len; ++i)
+    y[i] = filt->gain * buf[hist + i];
+
+  return buf[hist + len - 1];
+}
+
+SUPRIVATE void
+__su_iir_ols_finalize(su_iir_filt_t *filt)
+{
+  if (filt->ols_forward != NULL)
+    su_lib_release_plan(filt->ols_forward);
+
+  if (filt->ols_backward != NULL)
+    su_lib_release_plan(filt->ols_backward);
+
+  if (filt->ols_h != NULL)
+    SU_FFTW(_free)(filt->ols_h);
+
+  if (filt->ols_buf != NULL)
+    SU_FFTW(_free)(filt->ols_buf);
+
+  filt->ols_size = 0;
+  filt->ols_forward = NULL;
+  filt->ols_backward = NULL;
+  filt->ols_h = NULL;
+  filt->ols_buf = NULL;
+}
+
+SUPRIVATE SUBOOL
+__su_iir_ols_init(su_iir_filt_t *filt)
+{
+  SUCOMPLEX *buf;
+  SUFLOAT k;
+  unsigned int size = 1;
+  unsigned int order = 0;
+  unsigned int i;
+
+  while (size < SU_IIR_OLS_FFT_RATIO * filt->x_size) {
+    size <<= 1;
+    ++order;
+  }
+
+  if ((filt->ols_h = SU_FFTW(_malloc)(size * sizeof(SU_FFTW(_complex))))
+      == NULL)
+    goto fail;
+
+  if ((filt->ols_buf = SU_FFTW(_malloc)(size * sizeof(SU_FFTW(_complex))))
+      == NULL)
+    goto fail;
+
+  if ((filt->ols_forward = su_lib_acquire_dft_plan(
+           size,
+           1,
+           filt->ols_buf,
+           filt->ols_buf,
+           FFTW_FORWARD,
+           su_lib_fftw_strategy()))
+      == NULL)
+    goto fail;
+
+  if ((filt->ols_backward = su_lib_acquire_dft_plan(
+           size,
+           1,
+           filt->ols_buf,
+           filt->ols_buf,
+           FFTW_BACKWARD,
+           su_lib_fftw_strategy()))
+      == NULL)
+    goto fail;
+
+  /* Frequency response, including the normalization of the IFFT */
+  buf = filt->ols_h;
+  k = 1. / size;
+
+  memset(buf, 0, size * sizeof(SUCOMPLEX));
+  for (i = 0; i < filt->x_size; ++i)
+    buf[i] = k * filt->b[i];
+
+  SU_FFTW(_execute_dft)(filt->ols_forward, buf, buf);
+
+  filt->ols_size = size;
+  filt->ols_block = size - filt->x_size + 1;
+  filt->ols_cost = (SUSCOUNT)size * order;
+
+  return SU_TRUE;
+
+fail:
+  __su_iir_ols_finalize(filt);
+
+  return SU_FALSE;
+}
+
 void
 su_iir_filt_finalize(su_iir_filt_t *filt)
 {
-  if (filt->a != NULL)
+  if (filt->a != NULL && filt->a != filt->design)
     free(filt->a);
 
-  if (filt->b != NULL)
+  if (filt->b != NULL && filt->b != filt->design)
     free(filt->b);
 
   if (filt->x != NULL)
@@ -164,6 +637,22 @@ su_iir_filt_finalize(su_iir_filt_t *filt)
 
   if (filt->y != NULL)
     free(filt->y);
+
+  if (filt->x_lin != NULL)
+    free(filt->x_lin);
+
+  if (filt->y_lin != NULL)
+    free(filt->y_lin);
+
+  if (filt->sos != NULL && filt->sos != filt->design)
+    free(filt->sos);
+
+  if (filt->sos_state != NULL)
+    free(filt->sos_state);
+
+  su_design_release(filt->design);
+
+  __su_iir_ols_finalize(filt);
 }
 
 SUCOMPLEX
@@ -171,9 +660,13 @@ su_iir_filt_feed(su_iir_filt_t *filt, SUCOMPLEX x)
 {
   SUCOMPLEX y;
 
-  __su_iir_filt_push_x(filt, x);
-  y = __su_iir_filt_eval(filt);
-  __su_iir_filt_push_y(filt, y);
+  if (filt->sos_count > 0) {
+    y = __su_iir_sos_feed(filt, x);
+  } else {
+    __su_iir_filt_push_x(filt, x);
+    y = __su_iir_filt_eval(filt);
+    __su_iir_filt_push_y(filt, y);
+  }
 
   filt->curr_y = y;
 
@@ -183,20 +676,52 @@ su_iir_filt_feed(su_iir_filt_t *filt, SUCOMPLEX x)
 void
 su_iir_filt_feed_bulk(
     su_iir_filt_t *filt,
-    const SUCOMPLEX *__restrict x,
-    SUCOMPLEX *__restrict y,
+    const SUCOMPLEX *x,
+    SUCOMPLEX *y,
     SUSCOUNT len)
 {
-  SUCOMPLEX tmp_y = 0;
+  SUSCOUNT chunk;
+  SUSCOUNT i;
+
+  if (filt->sos_count > 0) {
+    if (len == 0)
+      return;
+
+    if (y != x)
+      memcpy(y, x, len * sizeof(SUCOMPLEX));
+
+    __su_iir_sos_feed_bulk(filt, y, len);
+
+    filt->curr_y = y[len - 1];
 
-  while (len-- != 0) {
-    __su_iir_filt_push_x(filt, *x++);
-    tmp_y = __su_iir_filt_eval(filt);
-    __su_iir_filt_push_y(filt, tmp_y);
-    *y++ = filt->gain * tmp_y;
+    for (i = 0; i < len; ++i)
+      y[i] *= filt->gain;
+
+    return;
+  }
+
+  if (filt->ols_size > 0) {
+    /*
+     * Full blocks always go through the FFTs. Short leftovers are
+     * cheaper to compute directly.
+     */
+    while (len > 0) {
+      chunk = SU_MIN(len, filt->ols_block);
+
+      if (chunk * filt->x_size >= filt->ols_cost)
+        filt->curr_y = __su_iir_ols_feed_block(filt, x, y, chunk);
+      else
+        filt->curr_y = __su_iir_filt_feed_direct(filt, x, y, chunk);
+
+      x += chunk;
+      y += chunk;
+      len -= chunk;
+    }
+
+    return;
   }
 
-  filt->curr_y = tmp_y;
+  filt->curr_y = __su_iir_filt_feed_direct(filt, x, y, len);
 }
 
 SUCOMPLEX
@@ -208,8 +733,15 @@ su_iir_filt_get(const su_iir_filt_t *filt)
 void
 su_iir_filt_reset(su_iir_filt_t *filt)
 {
-  memset(filt->x, 0, sizeof(SUCOMPLEX) * filt->x_alloc);
-  memset(filt->y, 0, sizeof(SUCOMPLEX) * filt->y_alloc);
+  if (filt->x != NULL)
+    memset(filt->x, 0, sizeof(SUCOMPLEX) * filt->x_alloc);
+
+  if (filt->y != NULL)
+    memset(filt->y, 0, sizeof(SUCOMPLEX) * filt->y_alloc);
+
+  if (filt->sos_state != NULL)
+    memset(filt->sos_state, 0, 2 * sizeof(SUCOMPLEX) * filt->sos_count);
+
   filt->curr_y = 0;
   filt->x_ptr = 0;
   filt->y_ptr = 0;
@@ -232,6 +764,8 @@ __su_iir_filt_init(
 {
   SUCOMPLEX *x = NULL;
   SUCOMPLEX *y = NULL;
+  SUCOMPLEX *x_lin = NULL;
+  SUCOMPLEX *y_lin = NULL;
   SUFLOAT *a_copy = NULL;
   SUFLOAT *b_copy = NULL;
   unsigned int x_alloc = x_size;
@@ -261,6 +795,15 @@ __su_iir_filt_init(
     if ((y = calloc(y_alloc, sizeof(SUCOMPLEX))) == NULL)
       goto fail;
 
+  if ((x_lin = malloc((x_size - 1 + SU_IIR_BLOCK_SIZE) * sizeof(SUCOMPLEX)))
+      == NULL)
+    goto fail;
+
+  if (y_size > 0)
+    if ((y_lin = malloc((y_size - 1 + SU_IIR_BLOCK_SIZE) * sizeof(SUCOMPLEX)))
+        == NULL)
+      goto fail;
+
   if (copy_coef) {
     if (y_size > 0) {
       if ((a_copy = malloc(y_size * sizeof(SUFLOAT))) == NULL)
@@ -281,6 +824,9 @@ __su_iir_filt_init(
   filt->x = x;
   filt->y = y;
 
+  filt->x_lin = x_lin;
+  filt->y_lin = y_lin;
+
   filt->a = a_copy;
   filt->b = b_copy;
 
@@ -293,6 +839,11 @@ __su_iir_filt_init(
   filt->x_alloc = x_alloc;
   filt->y_alloc = y_alloc;
 
+  /* Long FIR filters are run with fast convolution */
+  if (y_size == 0 && x_size >= SU_IIR_OLS_MIN_TAPS)
+    if (!__su_iir_ols_init(filt))
+      goto fail;
+
   return SU_TRUE;
 
 fail:
@@ -302,6 +853,12 @@ fail:
   if (y != NULL)
     free(y);
 
+  if (x_lin != NULL)
+    free(x_lin);
+
+  if (y_lin != NULL)
+    free(y_lin);
+
   if (copy_coef) {
     if (a_copy != NULL)
       free(a_copy);
@@ -310,6 +867,9 @@ fail:
       free(b_copy);
   }
 
+  /* Leave nothing behind for su_iir_filt_finalize */
+  memset(filt, 0, sizeof(su_iir_filt_t));
+
   return SU_FALSE;
 }
 
@@ -331,134 +891,132 @@ su_iir_filt_init(
 }
 
 SUBOOL
-su_iir_bwlpf_init(su_iir_filt_t *filt, SUSCOUNT n, SUFLOAT fc)
+__su_iir_filt_init_sos(
+    su_iir_filt_t *filt,
+    unsigned int count,
+    SUFLOAT *sos,
+    SUBOOL copy_coef)
 {
-  SUFLOAT *a = NULL;
-  SUFLOAT *b = NULL;
-  SUFLOAT scaling;
+  SUCOMPLEX *state = NULL;
+  SUFLOAT *sos_copy = NULL;
 
-  unsigned int i;
+  assert(count > 0);
 
-  if ((a = su_dcof_bwlp(n, fc)) == NULL)
-    goto fail;
+  memset(filt, 0, sizeof(su_iir_filt_t));
+
+  filt->gain = 1;
 
-  if ((b = su_ccof_bwlp(n)) == NULL)
+  if ((state = calloc(2 * count, sizeof(SUCOMPLEX))) == NULL)
     goto fail;
 
-  scaling = su_sf_bwlp(n, fc);
+  if (copy_coef) {
+    if ((sos_copy = malloc(5 * count * sizeof(SUFLOAT))) == NULL)
+      goto fail;
 
-  for (i = 0; i < n + 1; ++i)
-    b[i] *= scaling;
+    memcpy(sos_copy, sos, 5 * count * sizeof(SUFLOAT));
+  } else {
+    sos_copy = sos;
+  }
 
-  if (!__su_iir_filt_init(filt, n + 1, a, n + 1, b, SU_FALSE))
-    goto fail;
+  filt->sos_count = count;
+  filt->sos = sos_copy;
+  filt->sos_state = state;
 
   return SU_TRUE;
 
 fail:
-  if (a != NULL)
-    free(a);
-
-  if (b != NULL)
-    free(b);
+  if (state != NULL)
+    free(state);
 
   return SU_FALSE;
 }
 
 SUBOOL
-su_iir_bwhpf_init(su_iir_filt_t *filt, SUSCOUNT n, SUFLOAT fc)
+su_iir_filt_init_sos(
+    su_iir_filt_t *filt,
+    unsigned int count,
+    const SUFLOAT *sos)
 {
-  SUFLOAT *a = NULL;
-  SUFLOAT *b = NULL;
-  SUFLOAT scaling;
-
-  unsigned int i;
-
-  if ((a = su_dcof_bwhp(n, fc)) == NULL)
-    goto fail;
-
-  if ((b = su_ccof_bwhp(n)) == NULL)
-    goto fail;
+  return __su_iir_filt_init_sos(filt, count, (SUFLOAT *)sos, SU_TRUE);
+}
 
-  scaling = su_sf_bwhp(n, fc);
+/* Takes a cascade from the design cache, releasing it on failure */
+SUPRIVATE SUBOOL
+__su_iir_filt_take_sos(
+    su_iir_filt_t *filt,
+    const SUFLOAT *sos,
+    unsigned int count)
+{
+  if (sos == NULL)
+    return SU_FALSE;
 
-  for (i = 0; i < n + 1; ++i)
-    b[i] *= scaling;
+  if (!__su_iir_filt_init_sos(filt, count, (SUFLOAT *)sos, SU_FALSE)) {
+    su_design_release(sos);
+    return SU_FALSE;
+  }
 
-  if (!__su_iir_filt_init(filt, n + 1, a, n + 1, b, SU_FALSE))
-    goto fail;
+  filt->design = sos;
 
   return SU_TRUE;
+}
 
-fail:
-  if (a != NULL)
-    free(a);
+/* Same for FIR taps */
+SUPRIVATE SUBOOL
+__su_iir_filt_take_fir(su_iir_filt_t *filt, const SUFLOAT *b, SUSCOUNT n)
+{
+  if (b == NULL)
+    return SU_FALSE;
 
-  if (b != NULL)
-    free(b);
+  if (!__su_iir_filt_init(filt, 0, NULL, n, (SUFLOAT *)b, SU_FALSE)) {
+    su_design_release(b);
+    return SU_FALSE;
+  }
 
-  return SU_FALSE;
+  filt->design = b;
+
+  return SU_TRUE;
 }
 
 SUBOOL
-su_iir_bwbpf_init(su_iir_filt_t *filt, SUSCOUNT n, SUFLOAT f1, SUFLOAT f2)
+su_iir_bwlpf_init(su_iir_filt_t *filt, SUSCOUNT n, SUFLOAT fc)
 {
-  SUFLOAT *a = NULL;
-  SUFLOAT *b = NULL;
-  SUFLOAT scaling;
-
-  unsigned int i;
-
-  if ((a = su_dcof_bwbp(n, f1, f2)) == NULL)
-    goto fail;
+  const SUFLOAT *sos;
+  unsigned int count = 0;
 
-  if ((b = su_ccof_bwbp(n)) == NULL)
-    goto fail;
+  sos = su_design_sos_bwlp(n, fc, &count);
 
-  scaling = su_sf_bwbp(n, f1, f2);
+  return __su_iir_filt_take_sos(filt, sos, count);
+}
 
-  for (i = 0; i < n + 1; ++i) {
-    b[i] *= scaling;
-  }
+SUBOOL
+su_iir_bwhpf_init(su_iir_filt_t *filt, SUSCOUNT n, SUFLOAT fc)
+{
+  const SUFLOAT *sos;
+  unsigned int count = 0;
 
-  if (!__su_iir_filt_init(filt, 2 * n + 1, a, 2 * n + 1, b, SU_FALSE))
-    goto fail;
+  sos = su_design_sos_bwhp(n, fc, &count);
 
-  return SU_TRUE;
+  return __su_iir_filt_take_sos(filt, sos, count);
+}
 
-fail:
-  if (a != NULL)
-    free(a);
+SUBOOL
+su_iir_bwbpf_init(su_iir_filt_t *filt, SUSCOUNT n, SUFLOAT f1, SUFLOAT f2)
+{
+  const SUFLOAT *sos;
+  unsigned int count = 0;
 
-  if (b != NULL)
-    free(b);
+  sos = su_design_sos_bwbp(n, f1, f2, &count);
 
-  return SU_FALSE;
+  return __su_iir_filt_take_sos(filt, sos, count);
 }
 
 SUBOOL
 su_iir_rrc_init(su_iir_filt_t *filt, SUSCOUNT n, SUFLOAT T, SUFLOAT beta)
 {
-  SUFLOAT *b = NULL;
-
   if (n < 1)
-    goto fail;
+    return SU_FALSE;
 
-  if ((b = malloc(n * sizeof(SUFLOAT))) == NULL)
-    goto fail;
-
-  su_taps_rrc_init(b, T, beta, n);
-
-  if (!__su_iir_filt_init(filt, 0, NULL, n, b, SU_FALSE))
-    goto fail;
-
-  return SU_TRUE;
-
-fail:
-  if (b != NULL)
-    free(b);
-
-  return SU_FALSE;
+  return __su_iir_filt_take_fir(filt, su_design_rrc(T, beta, n), n);
 }
 
 SUBOOL
@@ -493,49 +1051,1143 @@ su_iir_brickwall_bp_init(
     SUFLOAT bw,
     SUFLOAT ifnor)
 {
-  SUFLOAT *b = NULL;
+  if (n < 1)
+    return SU_FALSE;
 
+  return __su_iir_filt_take_fir(filt, su_design_brickwall_bp(bw, ifnor, n), n);
+}
+
+SUBOOL
+su_iir_brickwall_lp_init(su_iir_filt_t *filt, SUSCOUNT n, SUFLOAT fc)
+{
   if (n < 1)
-    goto fail;
+    return SU_FALSE;
 
-  if ((b = malloc(n * sizeof(SUFLOAT))) == NULL)
-    goto fail;
+  return __su_iir_filt_take_fir(filt, su_design_brickwall_lp(fc, n), n);
+}
 
-  su_taps_brickwall_bp_init(b, bw, ifnor, n);
+/*********************** Parallel offline evaluation *************************/
+/*
+ * The state of a filter is the state of its sections or, for direct-form
+ * filters, its last y_size - 1 outputs (newest first). The input history
+ * of every chunk but the first is taken from the buffer itself.
+ */
+SUINLINE unsigned int
+__su_iir_filt_state_dim(const su_iir_filt_t *filt)
+{
+  if (filt->sos_count > 0)
+    return 2 * filt->sos_count;
 
-  if (!__su_iir_filt_init(filt, 0, NULL, n, b, SU_FALSE))
-    goto fail;
+  return filt->y_size > 0 ? filt->y_size - 1 : 0;
+}
 
-  return SU_TRUE;
+/* Steps the filter state with zero input, returning its output */
+SUINLINE SUCOMPLEX
+__su_iir_filt_zi_step(const su_iir_filt_t *filt, SUCOMPLEX *state)
+{
+  unsigned int dim = __su_iir_filt_state_dim(filt);
+  unsigned int i;
+  SUCOMPLEX y = 0;
 
-fail:
-  if (b != NULL)
-    free(b);
+  if (filt->sos_count > 0) {
+    for (i = 0; i < filt->sos_count; ++i)
+      y = __su_iir_sos_step(filt->sos + 5 * i, state + 2 * i, y);
+  } else if (dim > 0) {
+    for (i = 0; i < dim; ++i)
+      y -= filt->a[i + 1] * state[i];
 
-  return SU_FALSE;
+    memmove(state + 1, state, (dim - 1) * sizeof(SUCOMPLEX));
+    state[0] = y;
+  }
+
+  return y;
+}
+
+SUPRIVATE void
+__su_iir_filt_get_state(const su_iir_filt_t *filt, SUCOMPLEX *state)
+{
+  unsigned int dim = __su_iir_filt_state_dim(filt);
+  unsigned int i;
+  SUCOMPLEX tmp;
+
+  if (filt->sos_count > 0) {
+    memcpy(state, filt->sos_state, dim * sizeof(SUCOMPLEX));
+  } else if (dim > 0) {
+    __su_iir_filt_get_history(filt->y, filt->y_size, filt->y_ptr, state, dim);
+
+    for (i = 0; i < dim / 2; ++i) {
+      tmp = state[i];
+      state[i] = state[dim - 1 - i];
+      state[dim - 1 - i] = tmp;
+    }
+  }
+}
+
+SUPRIVATE void
+__su_iir_filt_set_state(su_iir_filt_t *filt, const SUCOMPLEX *state)
+{
+  unsigned int i = __su_iir_filt_state_dim(filt);
+
+  if (filt->sos_count > 0)
+    memcpy(filt->sos_state, state, i * sizeof(SUCOMPLEX));
+  else
+    while (i-- > 0)
+      __su_iir_filt_push_y(filt, state[i]);
+}
+
+/* Row-major dim x dim matrices */
+SUPRIVATE void
+__su_iir_matrix_mul(
+    SUDOUBLE *__restrict dest,
+    const SUDOUBLE *a,
+    const SUDOUBLE *b,
+    unsigned int dim)
+{
+  unsigned int i, j, k;
+  SUDOUBLE acc;
+
+  for (i = 0; i < dim; ++i)
+    for (j = 0; j < dim; ++j) {
+      acc = 0;
+      for (k = 0; k < dim; ++k)
+        acc += a[i * dim + k] * b[k * dim + j];
+      dest[i * dim + j] = acc;
+    }
+}
+
+/*
+ * Computes the matrix that takes the state of the filter len samples
+ * ahead with zero input, by exponentiation of the one-step transition
+ * matrix (whose columns are the steps of the canonical basis).
+ */
+SUPRIVATE SUBOOL
+__su_iir_filt_get_transition(
+    const su_iir_filt_t *filt,
+    SUSCOUNT len,
+    SUDOUBLE *phi)
+{
+  unsigned int dim = __su_iir_filt_state_dim(filt);
+  SUDOUBLE *base = NULL;
+  SUDOUBLE *tmp = NULL;
+  SUCOMPLEX *state = NULL;
+  unsigned int i, j;
+  SUBOOL ok = SU_FALSE;
+
+  if ((base = malloc(dim * dim * sizeof(SUDOUBLE))) == NULL)
+    goto done;
+
+  if ((tmp = malloc(dim * dim * sizeof(SUDOUBLE))) == NULL)
+    goto done;
+
+  if ((state = malloc(dim * sizeof(SUCOMPLEX))) == NULL)
+    goto done;
+
+  for (j = 0; j < dim; ++j) {
+    memset(state, 0, dim * sizeof(SUCOMPLEX));
+    state[j] = 1;
+
+    (void)__su_iir_filt_zi_step(filt, state);
+
+    for (i = 0; i < dim; ++i)
+      base[i * dim + j] = SU_C_REAL(state[i]);
+  }
+
+  memset(phi, 0, dim * dim * sizeof(SUDOUBLE));
+  for (i = 0; i < dim; ++i)
+    phi[i * dim + i] = 1;
+
+  while (len > 0) {
+    if (len & 1) {
+      __su_iir_matrix_mul(tmp, phi, base, dim);
+      memcpy(phi, tmp, dim * dim * sizeof(SUDOUBLE));
+    }
+
+    if ((len >>= 1) > 0) {
+      __su_iir_matrix_mul(tmp, base, base, dim);
+      memcpy(base, tmp, dim * dim * sizeof(SUDOUBLE));
+    }
+  }
+
+  ok = SU_TRUE;
+
+done:
+  if (base != NULL)
+    free(base);
+
+  if (tmp != NULL)
+    free(tmp);
+
+  if (state != NULL)
+    free(state);
+
+  return ok;
+}
+
+/* Copy of filt with zero state */
+SUPRIVATE SUBOOL
+__su_iir_filt_clone(const su_iir_filt_t *filt, su_iir_filt_t *clone)
+{
+  if (filt->sos_count > 0)
+    return __su_iir_filt_init_sos(clone, filt->sos_count, filt->sos, SU_TRUE);
+
+  return __su_iir_filt_init(
+      clone,
+      filt->y_size,
+      filt->a,
+      filt->x_size,
+      filt->b,
+      SU_TRUE);
+}
+
+struct su_iir_parallel_chunk {
+  const su_iir_filt_t *proto; /* Filter being run */
+  su_iir_filt_t *filt;        /* Filter used in the first pass */
+  const SUCOMPLEX *x;
+  SUCOMPLEX *y;
+  SUSCOUNT len;
+  SUCOMPLEX *state; /* Actual initial state, final state after second pass */
+  SUCOMPLEX last;   /* Last output, before gain */
+  unsigned int pass;
+  pthread_t thread;
+  SUBOOL running;
+};
+
+SUPRIVATE void *
+__su_iir_parallel_chunk_run(void *data)
+{
+  struct su_iir_parallel_chunk *chunk = (struct su_iir_parallel_chunk *)data;
+  const su_iir_filt_t *proto = chunk->proto;
+  SUSCOUNT n;
+
+  if (chunk->pass == 0) {
+    /* Zero-state response (actual response for the first chunk) */
+    su_iir_filt_feed_bulk(chunk->filt, chunk->x, chunk->y, chunk->len);
+  } else {
+    /* Add zero-input response to the actual initial state */
+    if (__su_iir_filt_state_dim(proto) > 0)
+      for (n = 0; n < chunk->len; ++n)
+        chunk->y[n] += __su_iir_filt_zi_step(proto, chunk->state);
+
+    chunk->last = chunk->y[chunk->len - 1];
+
+    for (n = 0; n < chunk->len; ++n)
+      chunk->y[n] *= proto->gain;
+  }
+
+  return NULL;
+}
+
+/* Threads that cannot be created run in the calling thread instead */
+SUPRIVATE void
+__su_iir_parallel_run(
+    struct su_iir_parallel_chunk *chunks,
+    unsigned int from,
+    unsigned int count,
+    unsigned int pass)
+{
+  unsigned int i;
+
+  for (i = from; i < count; ++i) {
+    chunks[i].pass = pass;
+    chunks[i].running = pthread_create(
+                            &chunks[i].thread,
+                            NULL,
+                            __su_iir_parallel_chunk_run,
+                            chunks + i)
+                        == 0;
+
+    if (!chunks[i].running)
+      (void)__su_iir_parallel_chunk_run(chunks + i);
+  }
+
+  for (i = from; i < count; ++i)
+    if (chunks[i].running)
+      pthread_join(chunks[i].thread, NULL);
 }
 
 SUBOOL
-su_iir_brickwall_lp_init(su_iir_filt_t *filt, SUSCOUNT n, SUFLOAT fc)
+su_iir_filt_feed_bulk_parallel(
+    su_iir_filt_t *filt,
+    const SUCOMPLEX *x,
+    SUCOMPLEX *y,
+    SUSCOUNT len,
+    unsigned int threads)
 {
-  SUFLOAT *b = NULL;
+  struct su_iir_parallel_chunk *chunks = NULL;
+  su_iir_filt_t *clones = NULL;
+  SUCOMPLEX *states = NULL; /* Actual state at the start of every chunk */
+  SUCOMPLEX *zs = NULL;     /* Zero-state final state of every chunk */
+  SUDOUBLE *phi = NULL;
+  SUCOMPLEX *prev, *curr;
+  unsigned int dim = __su_iir_filt_state_dim(filt);
+  unsigned int count, cloned = 0;
+  unsigned int i, j, k;
+  SUSCOUNT chunk_len, min_len, start;
+  SUDOUBLE re, im;
+  SUBOOL ok = SU_FALSE;
+
+  /* Chunks must contain the input history and final state of the next */
+  min_len = SU_MAX(SU_IIR_PARALLEL_MIN_CHUNK, filt->x_size + dim);
+  count = threads;
+  if (len / min_len < count)
+    count = len / min_len;
+
+  if (count < 2) {
+    su_iir_filt_feed_bulk(filt, x, y, len);
+    return SU_TRUE;
+  }
 
-  if (n < 1)
-    goto fail;
+  chunk_len = len / count;
 
-  if ((b = malloc(n * sizeof(SUFLOAT))) == NULL)
-    goto fail;
+  if ((chunks = calloc(count, sizeof(struct su_iir_parallel_chunk))) == NULL)
+    goto done;
 
-  su_taps_brickwall_lp_init(b, fc, n);
+  if ((clones = calloc(count - 1, sizeof(su_iir_filt_t))) == NULL)
+    goto done;
 
-  if (!__su_iir_filt_init(filt, 0, NULL, n, b, SU_FALSE))
-    goto fail;
+  if (dim > 0) {
+    if ((states = malloc(count * dim * sizeof(SUCOMPLEX))) == NULL)
+      goto done;
 
-  return SU_TRUE;
+    if ((zs = malloc(count * dim * sizeof(SUCOMPLEX))) == NULL)
+      goto done;
 
-fail:
-  if (b != NULL)
-    free(b);
+    if ((phi = malloc(dim * dim * sizeof(SUDOUBLE))) == NULL)
+      goto done;
+
+    if (!__su_iir_filt_get_transition(filt, chunk_len, phi))
+      goto done;
+  }
+
+  for (i = 0; i < count; ++i) {
+    start = i * chunk_len;
+
+    chunks[i].proto = filt;
+    chunks[i].x = x + start;
+    chunks[i].y = y + start;
+    chunks[i].len = i + 1 < count ? chunk_len : len - start;
+    chunks[i].state = dim > 0 ? states + i * dim : NULL;
+
+    if (i == 0) {
+      chunks[i].filt = filt;
+    } else {
+      if (!__su_iir_filt_clone(filt, clones + i - 1))
+        goto done;
+
+      ++cloned;
+
+      /* Direct form: the input history comes from the buffer */
+      if (filt->sos_count == 0)
+        for (k = filt->x_size - 1; k > 0; --k)
+          __su_iir_filt_push_x(clones + i - 1, x[start - k]);
+
+      chunks[i].filt = clones + i - 1;
+    }
+  }
+
+  /* First pass: all chunks from zero state (but the first) */
+  __su_iir_parallel_run(chunks, 0, count, 0);
+
+  /* Scan: actual state at the start of every chunk */
+  if (dim > 0) {
+    for (i = 1; i < count; ++i)
+      __su_iir_filt_get_state(clones + i - 1, zs + i * dim);
+
+    __su_iir_filt_get_state(filt, states + dim);
+
+    for (i = 2; i < count; ++i) {
+      prev = states + (i - 1) * dim;
+      curr = states + i * dim;
+
+      for (j = 0; j < dim; ++j) {
+        re = SU_C_REAL(zs[(i - 1) * dim + j]);
+        im = SU_C_IMAG(zs[(i - 1) * dim + j]);
+
+        for (k = 0; k < dim; ++k) {
+          re += phi[j * dim + k] * SU_C_REAL(prev[k]);
+          im += phi[j * dim + k] * SU_C_IMAG(prev[k]);
+        }
+
+        curr[j] = re + I * im;
+      }
+    }
+  }
+
+  /* Second pass: add the response to the actual initial state */
+  __su_iir_parallel_run(chunks, 1, count, 1);
+
+  /* Final state of the filter */
+  if (dim > 0) {
+    curr = states + (count - 1) * dim;
+
+    for (j = 0; j < dim; ++j)
+      curr[j] += zs[(count - 1) * dim + j];
+
+    __su_iir_filt_set_state(filt, curr);
+  }
+
+  /* Input history, as left by the last chunk (x may be overwritten) */
+  if (filt->sos_count == 0) {
+    memcpy(
+        filt->x,
+        clones[count - 2].x,
+        filt->x_alloc * sizeof(SUCOMPLEX));
+    filt->x_ptr = clones[count - 2].x_ptr;
+  }
+
+  filt->curr_y = chunks[count - 1].last;
+
+  ok = SU_TRUE;
+
+done:
+  for (i = 0; i < cloned; ++i)
+    su_iir_filt_finalize(clones + i);
+
+  if (clones != NULL)
+    free(clones);
+
+  if (chunks != NULL)
+    free(chunks);
+
+  if (states != NULL)
+    free(states);
+
+  if (zs != NULL)
+    free(zs);
+
+  if (phi != NULL)
+    free(phi);
+
+  return ok;
+}
+
+/******************************* Real filters ********************************/
+SUINLINE void
+__su_iir_rfilt_push(SUFLOAT *buf, unsigned int size, int *ptr, SUFLOAT x)
+{
+  if (--*ptr < 0)
+    *ptr += size;
+
+  buf[*ptr] = buf[*ptr + size] = x;
+}
+
+SUINLINE SUFLOAT
+__su_iir_rfilt_dot(const SUFLOAT *x, const SUFLOAT *h, unsigned int size)
+{
+  SUFLOAT acc = 0;
+#ifdef SU_USE_VOLK
+  volk_32f_x2_dot_prod_32f(&acc, x, h, size);
+#else
+  unsigned int i;
+
+  for (i = 0; i < size; ++i)
+    acc += h[i] * x[i];
+#endif /* SU_USE_VOLK */
+
+  return acc;
+}
+
+SUINLINE SUFLOAT
+__su_iir_rfilt_eval(const su_iir_rfilt_t *filt)
+{
+  SUFLOAT y = __su_iir_rfilt_dot(filt->x + filt->x_ptr, filt->b, filt->x_size);
+
+  /* Output feedback - assumes that a[0] is 1 */
+  if (filt->y_size > 1)
+    y -= __su_iir_rfilt_dot(
+        filt->y + filt->y_ptr,
+        filt->a + 1,
+        filt->y_size - 1);
+
+  return y;
+}
+
+SUINLINE SUFLOAT
+__su_iir_rfilt_direct_feed(su_iir_rfilt_t *filt, SUFLOAT x)
+{
+  SUFLOAT y;
+
+  __su_iir_rfilt_push(filt->x, filt->x_size, &filt->x_ptr, x);
+  y = __su_iir_rfilt_eval(filt);
+
+  if (filt->y_size > 0)
+    __su_iir_rfilt_push(filt->y, filt->y_size, &filt->y_ptr, y);
+
+  return y;
+}
+
+SUINLINE SUFLOAT
+__su_iir_rfilt_sos_feed(su_iir_rfilt_t *filt, SUFLOAT x)
+{
+  const SUFLOAT *c = filt->sos;
+  SUFLOAT *s = filt->sos_state;
+  SUFLOAT y;
+  unsigned int i;
+
+  for (i = 0; i < filt->sos_count; ++i, c += 5, s += 2) {
+    y = c[0] * x + s[0];
+    s[0] = c[1] * x - c[3] * y + s[1];
+    s[1] = c[2] * x - c[4] * y;
+    x = y;
+  }
+
+  return x;
+}
+
+/* Runs a section over a whole block, in place */
+SUPRIVATE void
+__su_iir_rfilt_sos_run(
+    const SUFLOAT *c,
+    SUFLOAT *state,
+    SUFLOAT *buf,
+    SUSCOUNT len)
+{
+  SUFLOAT b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+  SUFLOAT s1 = state[0], s2 = state[1];
+  SUFLOAT x, y;
+  SUSCOUNT i;
+
+  for (i = 0; i < len; ++i) {
+    x = buf[i];
+    y = b0 * x + s1;
+    s1 = b1 * x - a1 * y + s2;
+    s2 = b2 * x - a2 * y;
+    buf[i] = y;
+  }
+
+  state[0] = s1;
+  state[1] = s2;
+}
+
+void
+su_iir_rfilt_finalize(su_iir_rfilt_t *filt)
+{
+  if (filt->a != NULL && filt->a != filt->design)
+    free(filt->a);
+
+  if (filt->b != NULL && filt->b != filt->design)
+    free(filt->b);
+
+  if (filt->x != NULL)
+    free(filt->x);
+
+  if (filt->y != NULL)
+    free(filt->y);
+
+  if (filt->sos != NULL && filt->sos != filt->design)
+    free(filt->sos);
+
+  if (filt->sos_state != NULL)
+    free(filt->sos_state);
+
+  su_design_release(filt->design);
+}
+
+SUFLOAT
+su_iir_rfilt_feed(su_iir_rfilt_t *filt, SUFLOAT x)
+{
+  SUFLOAT y;
+
+  if (filt->sos_count > 0)
+    y = __su_iir_rfilt_sos_feed(filt, x);
+  else
+    y = __su_iir_rfilt_direct_feed(filt, x);
+
+  filt->curr_y = y;
+
+  return filt->gain * y;
+}
+
+void
+su_iir_rfilt_feed_bulk(
+    su_iir_rfilt_t *filt,
+    const SUFLOAT *x,
+    SUFLOAT *y,
+    SUSCOUNT len)
+{
+  unsigned int i;
+  SUSCOUNT j;
+
+  if (len == 0)
+    return;
+
+  if (filt->sos_count > 0) {
+    if (y != x)
+      memcpy(y, x, len * sizeof(SUFLOAT));
+
+    for (i = 0; i < filt->sos_count; ++i)
+      __su_iir_rfilt_sos_run(
+          filt->sos + 5 * i,
+          filt->sos_state + 2 * i,
+          y,
+          len);
+  } else {
+    for (j = 0; j < len; ++j)
+      y[j] = __su_iir_rfilt_direct_feed(filt, x[j]);
+  }
+
+  filt->curr_y = y[len - 1];
+
+  for (j = 0; j < len; ++j)
+    y[j] *= filt->gain;
+}
+
+SUFLOAT
+su_iir_rfilt_get(const su_iir_rfilt_t *filt)
+{
+  return filt->gain * filt->curr_y;
+}
+
+void
+su_iir_rfilt_reset(su_iir_rfilt_t *filt)
+{
+  if (filt->x != NULL)
+    memset(filt->x, 0, 2 * sizeof(SUFLOAT) * filt->x_size);
+
+  if (filt->y != NULL)
+    memset(filt->y, 0, 2 * sizeof(SUFLOAT) * filt->y_size);
+
+  if (filt->sos_state != NULL)
+    memset(filt->sos_state, 0, 2 * sizeof(SUFLOAT) * filt->sos_count);
+
+  filt->curr_y = 0;
+  filt->x_ptr = 0;
+  filt->y_ptr = 0;
+}
+
+void
+su_iir_rfilt_set_gain(su_iir_rfilt_t *filt, SUFLOAT gain)
+{
+  filt->gain = gain;
+}
+
+SUBOOL
+__su_iir_rfilt_init(
+    su_iir_rfilt_t *filt,
+    SUSCOUNT y_size,
+    SUFLOAT *__restrict a,
+    SUSCOUNT x_size,
+    SUFLOAT *__restrict b,
+    SUBOOL copy_coef)
+{
+  SUFLOAT *x = NULL;
+  SUFLOAT *y = NULL;
+  SUFLOAT *a_copy = NULL;
+  SUFLOAT *b_copy = NULL;
+
+  assert(x_size > 0);
+
+  memset(filt, 0, sizeof(su_iir_rfilt_t));
+
+  filt->gain = 1;
+
+  if ((x = calloc(2 * x_size, sizeof(SUFLOAT))) == NULL)
+    goto fail;
+
+  if (y_size > 0)
+    if ((y = calloc(2 * y_size, sizeof(SUFLOAT))) == NULL)
+      goto fail;
+
+  if (copy_coef) {
+    if (y_size > 0) {
+      if ((a_copy = malloc(y_size * sizeof(SUFLOAT))) == NULL)
+        goto fail;
+
+      memcpy(a_copy, a, y_size * sizeof(SUFLOAT));
+    }
+
+    if ((b_copy = malloc(x_size * sizeof(SUFLOAT))) == NULL)
+      goto fail;
+
+    memcpy(b_copy, b, x_size * sizeof(SUFLOAT));
+  } else {
+    a_copy = a;
+    b_copy = b;
+  }
+
+  filt->x = x;
+  filt->y = y;
+
+  filt->a = a_copy;
+  filt->b = b_copy;
+
+  filt->x_size = x_size;
+  filt->y_size = y_size;
+
+  return SU_TRUE;
+
+fail:
+  if (x != NULL)
+    free(x);
+
+  if (y != NULL)
+    free(y);
+
+  if (copy_coef) {
+    if (a_copy != NULL)
+      free(a_copy);
+
+    if (b_copy != NULL)
+      free(b_copy);
+  }
+
+  return SU_FALSE;
+}
+
+SUBOOL
+su_iir_rfilt_init(
+    su_iir_rfilt_t *filt,
+    SUSCOUNT y_size,
+    const SUFLOAT *__restrict a,
+    SUSCOUNT x_size,
+    const SUFLOAT *__restrict b)
+{
+  return __su_iir_rfilt_init(
+      filt,
+      y_size,
+      (SUFLOAT *)a,
+      x_size,
+      (SUFLOAT *)b,
+      SU_TRUE);
+}
+
+SUBOOL
+__su_iir_rfilt_init_sos(
+    su_iir_rfilt_t *filt,
+    unsigned int count,
+    SUFLOAT *sos,
+    SUBOOL copy_coef)
+{
+  SUFLOAT *state = NULL;
+  SUFLOAT *sos_copy = NULL;
+
+  assert(count > 0);
+
+  memset(filt, 0, sizeof(su_iir_rfilt_t));
+
+  filt->gain = 1;
+
+  if ((state = calloc(2 * count, sizeof(SUFLOAT))) == NULL)
+    goto fail;
+
+  if (copy_coef) {
+    if ((sos_copy = malloc(5 * count * sizeof(SUFLOAT))) == NULL)
+      goto fail;
+
+    memcpy(sos_copy, sos, 5 * count * sizeof(SUFLOAT));
+  } else {
+    sos_copy = sos;
+  }
+
+  filt->sos_count = count;
+  filt->sos = sos_copy;
+  filt->sos_state = state;
+
+  return SU_TRUE;
+
+fail:
+  if (state != NULL)
+    free(state);
+
+  return SU_FALSE;
+}
+
+SUBOOL
+su_iir_rfilt_init_sos(
+    su_iir_rfilt_t *filt,
+    unsigned int count,
+    const SUFLOAT *sos)
+{
+  return __su_iir_rfilt_init_sos(filt, count, (SUFLOAT *)sos, SU_TRUE);
+}
+
+/* Takes a cascade from the design cache, releasing it on failure */
+SUPRIVATE SUBOOL
+__su_iir_rfilt_take_sos(
+    su_iir_rfilt_t *filt,
+    const SUFLOAT *sos,
+    unsigned int count)
+{
+  if (sos == NULL)
+    return SU_FALSE;
+
+  if (!__su_iir_rfilt_init_sos(filt, count, (SUFLOAT *)sos, SU_FALSE)) {
+    su_design_release(sos);
+    return SU_FALSE;
+  }
+
+  filt->design = sos;
+
+  return SU_TRUE;
+}
+
+/* Same for FIR taps */
+SUPRIVATE SUBOOL
+__su_iir_rfilt_take_fir(su_iir_rfilt_t *filt, const SUFLOAT *b, SUSCOUNT n)
+{
+  if (b == NULL)
+    return SU_FALSE;
+
+  if (!__su_iir_rfilt_init(filt, 0, NULL, n, (SUFLOAT *)b, SU_FALSE)) {
+    su_design_release(b);
+    return SU_FALSE;
+  }
+
+  filt->design = b;
+
+  return SU_TRUE;
+}
+
+SUBOOL
+su_iir_rfilt_bwlpf_init(su_iir_rfilt_t *filt, SUSCOUNT n, SUFLOAT fc)
+{
+  const SUFLOAT *sos;
+  unsigned int count = 0;
+
+  sos = su_design_sos_bwlp(n, fc, &count);
+
+  return __su_iir_rfilt_take_sos(filt, sos, count);
+}
+
+SUBOOL
+su_iir_rfilt_bwhpf_init(su_iir_rfilt_t *filt, SUSCOUNT n, SUFLOAT fc)
+{
+  const SUFLOAT *sos;
+  unsigned int count = 0;
+
+  sos = su_design_sos_bwhp(n, fc, &count);
+
+  return __su_iir_rfilt_take_sos(filt, sos, count);
+}
+
+SUBOOL
+su_iir_rfilt_bwbpf_init(
+    su_iir_rfilt_t *filt,
+    SUSCOUNT n,
+    SUFLOAT f1,
+    SUFLOAT f2)
+{
+  const SUFLOAT *sos;
+  unsigned int count = 0;
+
+  sos = su_design_sos_bwbp(n, f1, f2, &count);
+
+  return __su_iir_rfilt_take_sos(filt, sos, count);
+}
+
+SUBOOL
+su_iir_rfilt_rrc_init(
+    su_iir_rfilt_t *filt,
+    SUSCOUNT n,
+    SUFLOAT T,
+    SUFLOAT beta)
+{
+  if (n < 1)
+    return SU_FALSE;
+
+  return __su_iir_rfilt_take_fir(filt, su_design_rrc(T, beta, n), n);
+}
+
+SUBOOL
+su_iir_rfilt_brickwall_lp_init(su_iir_rfilt_t *filt, SUSCOUNT n, SUFLOAT fc)
+{
+  if (n < 1)
+    return SU_FALSE;
+
+  return __su_iir_rfilt_take_fir(filt, su_design_brickwall_lp(fc, n), n);
+}
+
+SUBOOL
+su_iir_rfilt_brickwall_bp_init(
+    su_iir_rfilt_t *filt,
+    SUSCOUNT n,
+    SUFLOAT bw,
+    SUFLOAT ifnor)
+{
+  if (n < 1)
+    return SU_FALSE;
+
+  return __su_iir_rfilt_take_fir(
+      filt,
+      su_design_brickwall_bp(bw, ifnor, n),
+      n);
+}
+
+/*************************** Multi-stream filters ****************************/
+SUINLINE void
+__su_iir_mfilt_sos_step(
+    const SUFLOAT *c,
+    SUFLOAT *__restrict s1,
+    SUFLOAT *__restrict s2,
+    SUFLOAT *__restrict row,
+    unsigned int lanes)
+{
+  SUFLOAT b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+  SUFLOAT x, y;
+  unsigned int l;
+
+  for (l = 0; l < lanes; ++l) {
+    x = row[l];
+    y = b0 * x + s1[l];
+    s1[l] = b1 * x - a1 * y + s2[l];
+    s2[l] = b2 * x - a2 * y;
+    row[l] = y;
+  }
+}
+
+/* Runs the whole cascade over a block of rows, in place */
+SUPRIVATE void
+__su_iir_mfilt_sos_run(su_iir_mfilt_t *filt, SUFLOAT *buf, SUSCOUNT len)
+{
+  unsigned int W = filt->lanes;
+  const SUFLOAT *c;
+  SUFLOAT *s;
+  SUFLOAT *row;
+  SUSCOUNT n;
+  unsigned int i;
+
+  for (n = 0; n < len; ++n) {
+    row = buf + n * W;
+    c = filt->sos;
+    s = filt->sos_state;
+
+    for (i = 0; i < filt->sos_count; ++i, c += 5, s += 2 * W)
+      __su_iir_mfilt_sos_step(c, s, s + W, row, W);
+  }
+}
+
+SUINLINE void
+__su_iir_mfilt_push_row(
+    SUFLOAT *hist,
+    unsigned int size,
+    unsigned int lanes,
+    int *ptr,
+    const SUFLOAT *row)
+{
+  if (--*ptr < 0)
+    *ptr += size;
+
+  memcpy(hist + *ptr * lanes, row, lanes * sizeof(SUFLOAT));
+  memcpy(hist + (*ptr + size) * lanes, row, lanes * sizeof(SUFLOAT));
+}
+
+SUINLINE void
+__su_iir_mfilt_mac_row(
+    SUFLOAT *__restrict acc,
+    const SUFLOAT *__restrict row,
+    SUFLOAT k,
+    unsigned int lanes)
+{
+  unsigned int l;
+
+  for (l = 0; l < lanes; ++l)
+    acc[l] += k * row[l];
+}
+
+/* Direct form, one row at a time. x and y may be the same buffer */
+SUPRIVATE void
+__su_iir_mfilt_direct_run(
+    su_iir_mfilt_t *filt,
+    const SUFLOAT *x,
+    SUFLOAT *y,
+    SUSCOUNT len)
+{
+  unsigned int W = filt->lanes;
+  SUFLOAT *out;
+  SUSCOUNT n;
+  unsigned int i;
+
+  for (n = 0; n < len; ++n) {
+    out = y + n * W;
+
+    __su_iir_mfilt_push_row(filt->x, filt->x_size, W, &filt->x_ptr, x + n * W);
+
+    memset(out, 0, W * sizeof(SUFLOAT));
+
+    for (i = 0; i < filt->x_size; ++i)
+      __su_iir_mfilt_mac_row(
+          out,
+          filt->x + (filt->x_ptr + i) * W,
+          filt->b[i],
+          W);
+
+    /* Output feedback - assumes that a[0] is 1 */
+    for (i = 1; i < filt->y_size; ++i)
+      __su_iir_mfilt_mac_row(
+          out,
+          filt->y + (filt->y_ptr + i - 1) * W,
+          -filt->a[i],
+          W);
+
+    if (filt->y_size > 0)
+      __su_iir_mfilt_push_row(filt->y, filt->y_size, W, &filt->y_ptr, out);
+  }
+}
+
+void
+su_iir_mfilt_feed_interleaved(
+    su_iir_mfilt_t *filt,
+    const SUCOMPLEX *x,
+    SUCOMPLEX *y,
+    SUSCOUNT len)
+{
+  SUFLOAT *out = (SUFLOAT *)y;
+  SUSCOUNT count = len * filt->streams;
+  SUSCOUNT i;
+
+  if (filt->sos_count > 0) {
+    if (y != x)
+      memcpy(y, x, count * sizeof(SUCOMPLEX));
+
+    __su_iir_mfilt_sos_run(filt, out, len);
+  } else {
+    __su_iir_mfilt_direct_run(filt, (const SUFLOAT *)x, out, len);
+  }
+
+  if (filt->gain != 1)
+    for (i = 0; i < count; ++i)
+      y[i] *= filt->gain;
+}
+
+void
+su_iir_mfilt_feed_streams(
+    su_iir_mfilt_t *filt,
+    const SUCOMPLEX *const *x,
+    SUCOMPLEX *const *y,
+    SUSCOUNT len)
+{
+  SUCOMPLEX *buf = filt->scratch;
+  unsigned int N = filt->streams;
+  SUSCOUNT p = 0;
+  SUSCOUNT chunk, n;
+  unsigned int k;
+
+  while (p < len) {
+    chunk = SU_MIN(len - p, SU_IIR_MFILT_BLOCK);
+
+    for (k = 0; k < N; ++k)
+      for (n = 0; n < chunk; ++n)
+        buf[n * N + k] = x[k][p + n];
+
+    su_iir_mfilt_feed_interleaved(filt, buf, buf, chunk);
+
+    for (k = 0; k < N; ++k)
+      for (n = 0; n < chunk; ++n)
+        y[k][p + n] = buf[n * N + k];
+
+    p += chunk;
+  }
+}
+
+void
+su_iir_mfilt_reset(su_iir_mfilt_t *filt)
+{
+  unsigned int W = filt->lanes;
+
+  if (filt->x != NULL)
+    memset(filt->x, 0, 2 * filt->x_size * W * sizeof(SUFLOAT));
+
+  if (filt->y != NULL)
+    memset(filt->y, 0, 2 * filt->y_size * W * sizeof(SUFLOAT));
+
+  if (filt->sos_state != NULL)
+    memset(filt->sos_state, 0, 2 * filt->sos_count * W * sizeof(SUFLOAT));
+
+  filt->x_ptr = 0;
+  filt->y_ptr = 0;
+}
+
+void
+su_iir_mfilt_set_gain(su_iir_mfilt_t *filt, SUFLOAT gain)
+{
+  filt->gain = gain;
+}
+
+void
+su_iir_mfilt_finalize(su_iir_mfilt_t *filt)
+{
+  if (filt->a != NULL)
+    free(filt->a);
+
+  if (filt->b != NULL)
+    free(filt->b);
+
+  if (filt->x != NULL)
+    free(filt->x);
+
+  if (filt->y != NULL)
+    free(filt->y);
+
+  if (filt->sos != NULL)
+    free(filt->sos);
+
+  if (filt->sos_state != NULL)
+    free(filt->sos_state);
+
+  if (filt->scratch != NULL)
+    free(filt->scratch);
+
+  memset(filt, 0, sizeof(su_iir_mfilt_t));
+}
+
+SUBOOL
+su_iir_mfilt_init(
+    su_iir_mfilt_t *filt,
+    const su_iir_filt_t *proto,
+    unsigned int streams)
+{
+  unsigned int W = 2 * streams;
+
+  assert(streams > 0);
+
+  memset(filt, 0, sizeof(su_iir_mfilt_t));
+
+  filt->streams = streams;
+  filt->lanes = W;
+  filt->gain = proto->gain;
+
+  if (proto->sos_count > 0) {
+    if ((filt->sos = malloc(5 * proto->sos_count * sizeof(SUFLOAT))) == NULL)
+      goto fail;
+
+    memcpy(filt->sos, proto->sos, 5 * proto->sos_count * sizeof(SUFLOAT));
+
+    if ((filt->sos_state = calloc(2 * proto->sos_count * W, sizeof(SUFLOAT)))
+        == NULL)
+      goto fail;
+
+    filt->sos_count = proto->sos_count;
+  } else {
+    if ((filt->b = malloc(proto->x_size * sizeof(SUFLOAT))) == NULL)
+      goto fail;
+
+    memcpy(filt->b, proto->b, proto->x_size * sizeof(SUFLOAT));
+
+    if ((filt->x = calloc(2 * proto->x_size * W, sizeof(SUFLOAT))) == NULL)
+      goto fail;
+
+    if (proto->y_size > 0) {
+      if ((filt->a = malloc(proto->y_size * sizeof(SUFLOAT))) == NULL)
+        goto fail;
+
+      memcpy(filt->a, proto->a, proto->y_size * sizeof(SUFLOAT));
+
+      if ((filt->y = calloc(2 * proto->y_size * W, sizeof(SUFLOAT))) == NULL)
+        goto fail;
+    }
+
+    filt->x_size = proto->x_size;
+    filt->y_size = proto->y_size;
+  }
+
+  if ((filt->scratch = calloc(SU_IIR_MFILT_BLOCK * streams, sizeof(SUCOMPLEX)))
+      == NULL)
+    goto fail;
+
+  return SU_TRUE;
+
+fail:
+  su_iir_mfilt_finalize(filt);
 
   return SU_FALSE;
 }
@@ -22,6 +22,7 @@
 #define SU_LOG_LEVEL "lib"
 
 #include <sigutils/sigutils.h>
+#include <sigutils/refcache.h>
 #include <pthread.h>
 
 #define SU_MIN_PRECALC_FFT_EXP 9  /* 512 bin FFT */
@@ -31,7 +32,49 @@ SUPRIVATE SUBOOL          g_fftw_init       = SU_FALSE;
 SUPRIVATE SUBOOL          g_su_log_cr       = SU_TRUE;
 SUPRIVATE SUBOOL          g_su_measure_ffts = SU_FALSE;
 SUPRIVATE char           *g_su_wisdom_file  = NULL;
-SUPRIVATE pthread_mutex_t g_fft_plan_mutex  = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * The FFTW planner is not thread-safe, so every call to it (planning and
+ * destroying plans) is serialized by this mutex. The plan cache has a lock
+ * of its own and plans out of it: measuring a plan may take tens of
+ * milliseconds, and threads that only need a cached plan should not wait
+ * for it.
+ */
+SUPRIVATE pthread_mutex_t g_fft_planner_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Plan cache. Plans are indexed by everything that makes them different
+ * from the point of view of fftw_execute_dft: plans with the same size,
+ * direction, flags, thread count and buffer alignment can be shared
+ * by any number of objects, as long as they are executed on their own
+ * arrays. Plans that are no longer in use are kept around (up to
+ * SU_LIB_PLAN_CACHE_MAX_IDLE of them) so that objects that are created
+ * and destroyed repeatedly do not need to plan again.
+ */
+#define SU_LIB_PLAN_CACHE_MAX_IDLE 32
+
+enum sigutils_plan_kind {
+  SU_LIB_PLAN_KIND_C2C,
+  SU_LIB_PLAN_KIND_R2C
+};
+
+struct sigutils_plan_cache_entry {
+  struct sigutils_refcache_entry header; /* data: plan */
+
+  enum sigutils_plan_kind kind;
+  int      n;
+  int      howmany;
+  int      sign;
+  unsigned flags;
+  int      nthreads;
+  int      in_alignment;
+  int      out_alignment;
+  SUBOOL   in_place;
+
+  SU_FFTW(_plan) plan;
+  void *in;  /* Planning arrays, not part of the key */
+  void *out;
+};
 
 SUPRIVATE char
 su_log_severity_to_char(enum sigutils_log_severity sev)
@@ -134,22 +177,26 @@ su_lib_fftw_strategy(void)
   return g_su_measure_ffts ? FFTW_MEASURE : FFTW_ESTIMATE;
 }
 
+SUINLINE int
+su_lib_fftw_threads(int n)
+{
+  if (n < 32768)
+    return 1;
+  else if (n == 32768)
+    return 2;
+
+  return 4;
+}
+
 SU_FFTW(_plan)
 su_lib_plan_dft_1d(int n, SU_FFTW(_complex) *in, SU_FFTW(_complex) *out,
         int sign, unsigned flags)
 {
   SU_FFTW(_plan) plan = NULL;
   SUBOOL mutex_acquired = SU_FALSE;
-  int nthreads;
-
-  if (n < 32768)
-    nthreads = 1;
-  else if (n == 32768)
-    nthreads = 2;
-  else
-    nthreads = 4;
+  int nthreads = su_lib_fftw_threads(n);
 
-  SU_TRYZ(pthread_mutex_lock(&g_fft_plan_mutex));
+  SU_TRYZ(pthread_mutex_lock(&g_fft_planner_mutex));
   mutex_acquired = SU_TRUE;
 
   SU_FFTW(_plan_with_nthreads)(nthreads);
@@ -158,12 +205,231 @@ su_lib_plan_dft_1d(int n, SU_FFTW(_complex) *in, SU_FFTW(_complex) *out,
 done:
   if (mutex_acquired) {
     SU_FFTW(_plan_with_nthreads)(1);
-    pthread_mutex_unlock(&g_fft_plan_mutex);
+    pthread_mutex_unlock(&g_fft_planner_mutex);
   }
 
   return plan;
 }
 
+SUPRIVATE void
+su_lib_destroy_plan(SU_FFTW(_plan) plan)
+{
+  SU_TRYZ(pthread_mutex_lock(&g_fft_planner_mutex));
+
+  SU_FFTW(_destroy_plan)(plan);
+
+  pthread_mutex_unlock(&g_fft_planner_mutex);
+
+done:
+  return;
+}
+
+SUPRIVATE SUBOOL
+su_lib_plan_cache_entry_match(
+    const struct sigutils_refcache_entry *header,
+    const void *key)
+{
+  const struct sigutils_plan_cache_entry *entry =
+      (const struct sigutils_plan_cache_entry *)header;
+  const struct sigutils_plan_cache_entry *k =
+      (const struct sigutils_plan_cache_entry *)key;
+
+  return entry->kind          == k->kind
+      && entry->n             == k->n
+      && entry->howmany       == k->howmany
+      && entry->sign          == k->sign
+      && entry->flags         == k->flags
+      && entry->nthreads      == k->nthreads
+      && entry->in_alignment  == k->in_alignment
+      && entry->out_alignment == k->out_alignment
+      && entry->in_place      == k->in_place;
+}
+
+SUPRIVATE void
+su_lib_plan_cache_entry_destroy(struct sigutils_refcache_entry *header)
+{
+  struct sigutils_plan_cache_entry *entry =
+      (struct sigutils_plan_cache_entry *)header;
+
+  if (entry->plan != NULL)
+    su_lib_destroy_plan(entry->plan);
+
+  free(entry);
+}
+
+/* Plans the transform described by key, on the arrays it points to */
+SUPRIVATE struct sigutils_refcache_entry *
+su_lib_plan_cache_entry_create(const void *key)
+{
+  struct sigutils_plan_cache_entry *entry = NULL;
+  SUBOOL planner_acquired = SU_FALSE;
+  int n;
+
+  SU_ALLOCATE(entry, struct sigutils_plan_cache_entry);
+  *entry = *(const struct sigutils_plan_cache_entry *)key;
+
+  n = entry->n;
+
+  SU_TRYZ(pthread_mutex_lock(&g_fft_planner_mutex));
+  planner_acquired = SU_TRUE;
+
+  SU_FFTW(_plan_with_nthreads)(entry->nthreads);
+
+  switch (entry->kind) {
+    case SU_LIB_PLAN_KIND_C2C:
+      entry->plan = SU_FFTW(_plan_many_dft)(
+          1,              /* rank */
+          &n,             /* n */
+          entry->howmany, /* howmany */
+          entry->in,      /* in */
+          NULL,           /* inembed */
+          1,              /* istride */
+          n,              /* idist */
+          entry->out,     /* out */
+          NULL,           /* onembed */
+          1,              /* ostride */
+          n,              /* odist */
+          entry->sign,
+          entry->flags);
+      break;
+
+    case SU_LIB_PLAN_KIND_R2C:
+      entry->plan =
+          SU_FFTW(_plan_dft_r2c_1d)(n, entry->in, entry->out, entry->flags);
+      break;
+  }
+
+  SU_FFTW(_plan_with_nthreads)(1);
+
+  pthread_mutex_unlock(&g_fft_planner_mutex);
+  planner_acquired = SU_FALSE;
+
+  SU_TRY(entry->plan != NULL);
+
+  entry->header.data = entry->plan;
+  entry->in  = NULL;
+  entry->out = NULL;
+
+  return &entry->header;
+
+done:
+  if (planner_acquired) {
+    SU_FFTW(_plan_with_nthreads)(1);
+    pthread_mutex_unlock(&g_fft_planner_mutex);
+  }
+
+  if (entry != NULL)
+    su_lib_plan_cache_entry_destroy(&entry->header);
+
+  return NULL;
+}
+
+SUPRIVATE const struct sigutils_refcache_class g_plan_cache_class = {
+    su_lib_plan_cache_entry_match,
+    su_lib_plan_cache_entry_create,
+    su_lib_plan_cache_entry_destroy,
+    SU_LIB_PLAN_CACHE_MAX_IDLE,
+    0};
+
+SUPRIVATE su_refcache_t g_plan_cache =
+    su_refcache_INITIALIZER(&g_plan_cache_class);
+
+SUPRIVATE SU_FFTW(_plan)
+su_lib_acquire_plan(
+    struct sigutils_plan_cache_entry *key,
+    void *in,
+    void *out)
+{
+  const struct sigutils_plan_cache_entry *entry;
+
+  key->in  = in;
+  key->out = out;
+
+  entry = (const struct sigutils_plan_cache_entry *)su_refcache_acquire(
+      &g_plan_cache,
+      key);
+
+  return entry != NULL ? entry->plan : NULL;
+}
+
+/*
+ * Returns a shared plan for howmany contiguous transforms of size n. The
+ * plan must be executed with fftw_execute_dft on arrays with the same
+ * alignment (and in-placeness) of the arrays passed here, and released
+ * with su_lib_release_plan. If the plan is not cached yet and flags
+ * require measuring, the contents of in and out are overwritten.
+ */
+SU_FFTW(_plan)
+su_lib_acquire_dft_plan(int n, int howmany, SU_FFTW(_complex) *in,
+        SU_FFTW(_complex) *out, int sign, unsigned flags)
+{
+  struct sigutils_plan_cache_entry key;
+
+  memset(&key, 0, sizeof(key));
+
+  key.kind          = SU_LIB_PLAN_KIND_C2C;
+  key.n             = n;
+  key.howmany       = howmany;
+  key.sign          = sign;
+  key.flags         = flags;
+  key.nthreads      = howmany == 1 ? su_lib_fftw_threads(n) : 1;
+  key.in_alignment  = SU_FFTW(_alignment_of)((SUFLOAT *) in);
+  key.out_alignment = SU_FFTW(_alignment_of)((SUFLOAT *) out);
+  key.in_place      = (void *) in == (void *) out;
+
+  return su_lib_acquire_plan(&key, in, out);
+}
+
+/*
+ * Same as above, for a real-to-complex forward transform of size n.
+ * Executed with fftw_execute_dft_r2c, it produces n / 2 + 1 bins.
+ */
+SU_FFTW(_plan)
+su_lib_acquire_dft_r2c_plan(int n, SUFLOAT *in, SU_FFTW(_complex) *out,
+        unsigned flags)
+{
+  struct sigutils_plan_cache_entry key;
+
+  memset(&key, 0, sizeof(key));
+
+  key.kind          = SU_LIB_PLAN_KIND_R2C;
+  key.n             = n;
+  key.howmany       = 1;
+  key.sign          = FFTW_FORWARD;
+  key.flags         = flags;
+  key.nthreads      = su_lib_fftw_threads(n);
+  key.in_alignment  = SU_FFTW(_alignment_of)(in);
+  key.out_alignment = SU_FFTW(_alignment_of)((SUFLOAT *) out);
+  key.in_place      = (void *) in == (void *) out;
+
+  return su_lib_acquire_plan(&key, in, out);
+}
+
+void
+su_lib_release_plan(SU_FFTW(_plan) plan)
+{
+  if (plan == NULL)
+    return;
+
+  if (!su_refcache_release(&g_plan_cache, plan)) {
+    SU_WARNING("Releasing a plan that does not belong to the plan cache\n");
+    su_lib_destroy_plan(plan);
+  }
+}
+
+void
+su_lib_get_plan_cache_stats(struct sigutils_plan_cache_stats *stats)
+{
+  struct sigutils_refcache_stats cache_stats;
+
+  su_refcache_get_stats(&g_plan_cache, &cache_stats);
+
+  stats->hits    = cache_stats.hits;
+  stats->misses  = cache_stats.misses;
+  stats->entries = cache_stats.entries;
+  stats->idle    = cache_stats.idle;
+}
+
 void
 su_lib_gen_wisdom(void)
 {
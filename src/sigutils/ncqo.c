@@ -19,6 +19,8 @@
 
 #define _GNU_SOURCE
 #include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
 
 #define SU_LOG_DOMAIN "ncqo"
@@ -27,6 +29,60 @@
 #include <sigutils/ncqo.h>
 #include <sigutils/sampling.h>
 
+/*
+ * Sine table shared by all oscillators in the LUT modes. It spans a
+ * cycle and a quarter (so cosines are read at an offset of a quarter
+ * cycle) plus one entry for interpolation.
+ */
+#define SU_NCQO_LUT_SHIFT (32 - SU_NCQO_LUT_BITS)
+#define SU_NCQO_LUT_COS_OFFSET (SU_NCQO_LUT_SIZE >> 2)
+#define SU_NCQO_LUT_LEN (SU_NCQO_LUT_SIZE + SU_NCQO_LUT_COS_OFFSET + 1)
+
+SUPRIVATE SUFLOAT g_su_ncqo_lut[SU_NCQO_LUT_LEN];
+SUPRIVATE pthread_once_t g_su_ncqo_lut_once = PTHREAD_ONCE_INIT;
+
+SUPRIVATE void
+su_ncqo_lut_init(void)
+{
+  unsigned int i;
+
+  for (i = 0; i < SU_NCQO_LUT_LEN; ++i)
+    g_su_ncqo_lut[i] = sin(2 * M_PI * i / SU_NCQO_LUT_SIZE);
+}
+
+SUINLINE SUFLOAT
+__su_ncqo_lut_read(const su_ncqo_t *ncqo, unsigned int offset)
+{
+  unsigned int n;
+  SUFLOAT frac;
+
+  if (ncqo->mode == SU_NCQO_MODE_LUT) {
+    /* Round to the nearest entry. Wrapping around is harmless. */
+    n = (uint32_t) (ncqo->acc + (1u << (SU_NCQO_LUT_SHIFT - 1)))
+        >> SU_NCQO_LUT_SHIFT;
+
+    return g_su_ncqo_lut[n + offset];
+  }
+
+  n = (ncqo->acc >> SU_NCQO_LUT_SHIFT) + offset;
+  frac = (SUFLOAT) (ncqo->acc & ((1u << SU_NCQO_LUT_SHIFT) - 1))
+         * (1.f / (1u << SU_NCQO_LUT_SHIFT));
+
+  return g_su_ncqo_lut[n] + frac * (g_su_ncqo_lut[n + 1] - g_su_ncqo_lut[n]);
+}
+
+#define __su_ncqo_lut_cos(ncqo) __su_ncqo_lut_read(ncqo, SU_NCQO_LUT_COS_OFFSET)
+#define __su_ncqo_lut_sin(ncqo) __su_ncqo_lut_read(ncqo, 0)
+
+/* Normalized frequencies are exact in fixed point more often than omega */
+SUINLINE void
+__su_ncqo_sync_dacc(su_ncqo_t *ncqo)
+{
+  if (ncqo->mode != SU_NCQO_MODE_FLOAT)
+    ncqo->dacc =
+        (uint32_t) (int64_t) floor(.5 + (double) ncqo->fnor * 2147483648.);
+}
+
 /* Expects: relative frequency */
 SU_CONSTRUCTOR_TYPED(void, su_ncqo, SUFLOAT fnor)
 {
@@ -36,7 +92,12 @@ SU_CONSTRUCTOR_TYPED(void, su_ncqo, SUFLOAT fnor)
   self->sin = 0;
   self->cos = 1;
 
+  self->mode = SU_NCQO_MODE_FLOAT;
+  self->acc = 0;
+  self->dacc = 0;
+
 #ifdef SU_NCQO_USE_PRECALC_BUFFER
+  self->precalc = NULL;
   self->p = 0;
   self->pre_c = SU_FALSE;
 #endif /* SU_NCQO_USE_PRECALC_BUFFER */
@@ -47,17 +108,80 @@ SU_METHOD(su_ncqo, void, init_fixed, SUFLOAT fnor)
   su_ncqo_init(self, fnor);
 
 #ifdef SU_NCQO_USE_PRECALC_BUFFER
+  /* Without precalculated values, this is just a regular oscillator */
+  if ((self->precalc = malloc(sizeof(struct sigutils_ncqo_precalc)))
+      == NULL) {
+    SU_WARNING("Cannot allocate precalculated buffers\n");
+    return;
+  }
+
   self->pre_c = SU_TRUE;
   __su_ncqo_populate_precalc_buffer(self);
 #endif /* SU_NCQO_USE_PRECALC_BUFFER */
 }
 
+SU_METHOD(su_ncqo, void, finalize)
+{
+#ifdef SU_NCQO_USE_PRECALC_BUFFER
+  if (self->precalc != NULL) {
+    free(self->precalc);
+    self->precalc = NULL;
+  }
+
+  self->pre_c = SU_FALSE;
+#endif /* SU_NCQO_USE_PRECALC_BUFFER */
+}
+
+SU_METHOD(su_ncqo, void, init_lut, SUFLOAT fnor, SUBOOL interp)
+{
+  su_ncqo_init(self, fnor);
+
+  (void) su_ncqo_set_mode(
+      self,
+      interp ? SU_NCQO_MODE_LUT_INTERP : SU_NCQO_MODE_LUT);
+}
+
+SU_METHOD(su_ncqo, SUBOOL, set_mode, enum sigutils_ncqo_mode mode)
+{
+#ifdef SU_NCQO_USE_PRECALC_BUFFER
+  if (self->pre_c) {
+    SU_ERROR("Cannot change the mode of a fixed NCQO\n");
+    return SU_FALSE;
+  }
+#endif /* SU_NCQO_USE_PRECALC_BUFFER */
+
+  if (mode == self->mode)
+    return SU_TRUE;
+
+  if (mode == SU_NCQO_MODE_FLOAT) {
+    self->phi = su_ncqo_acc2ang(self->acc);
+    self->cos_updated = SU_FALSE;
+    self->sin_updated = SU_FALSE;
+  } else {
+    (void) pthread_once(&g_su_ncqo_lut_once, su_ncqo_lut_init);
+
+    if (self->mode == SU_NCQO_MODE_FLOAT)
+      self->acc = su_ncqo_ang2acc(self->phi);
+  }
+
+  self->mode = mode;
+  __su_ncqo_sync_dacc(self);
+
+  return SU_TRUE;
+}
+
 SU_METHOD(su_ncqo, void, copy, const su_ncqo_t *ncqo)
 {
 #ifdef SU_NCQO_USE_PRECALC_BUFFER
   if (self->pre_c) {
-    /* We need all the info here */
+    /* We need all the info here, but not the precalc buffer pointer */
+    struct sigutils_ncqo_precalc *precalc = self->precalc;
+
     memcpy(self, ncqo, sizeof(su_ncqo_t));
+    self->precalc = precalc;
+
+    if (ncqo->pre_c)
+      memcpy(precalc, ncqo->precalc, sizeof(struct sigutils_ncqo_precalc));
   } else {
 #endif /* SU_NCQO_USE_PRECALC_BUFFER */
     /* Copy only the relevant fields */
@@ -70,6 +194,10 @@ SU_METHOD(su_ncqo, void, copy, const su_ncqo_t *ncqo)
 
     self->cos_updated = ncqo->cos_updated;
     self->cos = ncqo->cos;
+
+    self->mode = ncqo->mode;
+    self->acc = ncqo->acc;
+    self->dacc = ncqo->dacc;
 #ifdef SU_NCQO_USE_PRECALC_BUFFER
   }
 #endif /* SU_NCQO_USE_PRECALC_BUFFER */
@@ -102,6 +230,11 @@ SU_METHOD(su_ncqo, void, set_phase, SUFLOAT phi)
   }
 #endif /* SU_NCQO_USE_PRECALC_BUFFER */
 
+  if (self->mode != SU_NCQO_MODE_FLOAT) {
+    self->acc = su_ncqo_ang2acc(phi);
+    return;
+  }
+
   self->phi = phi - 2 * PI * SU_FLOOR(phi / (2 * PI));
 }
 
@@ -109,9 +242,12 @@ SU_METHOD(su_ncqo, SUFLOAT, get_i)
 {
 #ifdef SU_NCQO_USE_PRECALC_BUFFER
   if (self->pre_c) {
-    return self->cos_buffer[self->p];
+    return self->precalc->cos_buffer[self->p];
   } else {
 #endif /* SU_NCQO_USE_PRECALC_BUFFER */
+    if (self->mode != SU_NCQO_MODE_FLOAT)
+      return __su_ncqo_lut_cos(self);
+
     __su_ncqo_assert_cos(self);
     return self->cos;
 #ifdef SU_NCQO_USE_PRECALC_BUFFER
@@ -123,9 +259,12 @@ SU_METHOD(su_ncqo, SUFLOAT, get_q)
 {
 #ifdef SU_NCQO_USE_PRECALC_BUFFER
   if (self->pre_c) {
-    return self->sin_buffer[self->p];
+    return self->precalc->sin_buffer[self->p];
   } else {
 #endif /* SU_NCQO_USE_PRECALC_BUFFER */
+    if (self->mode != SU_NCQO_MODE_FLOAT)
+      return __su_ncqo_lut_sin(self);
+
     __su_ncqo_assert_sin(self);
     return self->sin;
 #ifdef SU_NCQO_USE_PRECALC_BUFFER
@@ -137,9 +276,12 @@ SU_METHOD(su_ncqo, SUCOMPLEX, get)
 {
 #ifdef SU_NCQO_USE_PRECALC_BUFFER
   if (self->pre_c) {
-    return self->cos_buffer[self->p] + I * self->sin_buffer[self->p];
+    return self->precalc->cos_buffer[self->p] + I * self->precalc->sin_buffer[self->p];
   } else {
 #endif /* SU_NCQO_USE_PRECALC_BUFFER */
+    if (self->mode != SU_NCQO_MODE_FLOAT)
+      return __su_ncqo_lut_cos(self) + I * __su_ncqo_lut_sin(self);
+
     __su_ncqo_assert_cos(self);
     __su_ncqo_assert_sin(self);
 
@@ -155,10 +297,16 @@ SU_METHOD(su_ncqo, SUFLOAT, read_i)
 
 #ifdef SU_NCQO_USE_PRECALC_BUFFER
   if (self->pre_c) {
-    old = self->cos_buffer[self->p];
+    old = self->precalc->cos_buffer[self->p];
     __su_ncqo_step_precalc(self);
   } else {
 #endif /* SU_NCQO_USE_PRECALC_BUFFER */
+    if (self->mode != SU_NCQO_MODE_FLOAT) {
+      old = __su_ncqo_lut_cos(self);
+      __su_ncqo_step(self);
+      return old;
+    }
+
     old = self->cos;
 
     __su_ncqo_step(self);
@@ -179,10 +327,16 @@ SU_METHOD(su_ncqo, SUFLOAT, read_q)
 
 #ifdef SU_NCQO_USE_PRECALC_BUFFER
   if (self->pre_c) {
-    old = self->sin_buffer[self->p];
+    old = self->precalc->sin_buffer[self->p];
     __su_ncqo_step_precalc(self);
   } else {
 #endif /* SU_NCQO_USE_PRECALC_BUFFER */
+    if (self->mode != SU_NCQO_MODE_FLOAT) {
+      old = __su_ncqo_lut_sin(self);
+      __su_ncqo_step(self);
+      return old;
+    }
+
     old = self->sin;
 
     __su_ncqo_step(self);
@@ -203,10 +357,16 @@ SU_METHOD(su_ncqo, SUCOMPLEX, read)
 
 #ifdef SU_NCQO_USE_PRECALC_BUFFER
   if (self->pre_c) {
-    old = self->cos_buffer[self->p] + I * self->sin_buffer[self->p];
+    old = self->precalc->cos_buffer[self->p] + I * self->precalc->sin_buffer[self->p];
     __su_ncqo_step_precalc(self);
   } else {
 #endif /* SU_NCQO_USE_PRECALC_BUFFER */
+    if (self->mode != SU_NCQO_MODE_FLOAT) {
+      old = __su_ncqo_lut_cos(self) + I * __su_ncqo_lut_sin(self);
+      __su_ncqo_step(self);
+      return old;
+    }
+
     old = self->cos + I * self->sin;
 
     __su_ncqo_step(self);
@@ -234,6 +394,8 @@ SU_METHOD(su_ncqo, void, set_angfreq, SUFLOAT omrel)
 
   self->omega = omrel;
   self->fnor = SU_ANG2NORM_FREQ(omrel);
+
+  __su_ncqo_sync_dacc(self);
 }
 
 SU_METHOD(su_ncqo, void, inc_angfreq, SUFLOAT delta)
@@ -247,6 +409,8 @@ SU_METHOD(su_ncqo, void, inc_angfreq, SUFLOAT delta)
 
   self->omega += delta;
   self->fnor = SU_ANG2NORM_FREQ(self->omega);
+
+  __su_ncqo_sync_dacc(self);
 }
 
 SU_GETTER(su_ncqo, SUFLOAT, get_angfreq)
@@ -265,6 +429,8 @@ SU_METHOD(su_ncqo, void, set_freq, SUFLOAT fnor)
 
   self->fnor = fnor;
   self->omega = SU_NORM2ANG_FREQ(fnor);
+
+  __su_ncqo_sync_dacc(self);
 }
 
 SU_METHOD(su_ncqo, void, inc_freq, SUFLOAT delta)
@@ -278,9 +444,137 @@ SU_METHOD(su_ncqo, void, inc_freq, SUFLOAT delta)
 
   self->fnor += delta;
   self->omega = SU_NORM2ANG_FREQ(self->fnor);
+
+  __su_ncqo_sync_dacc(self);
 }
 
 SU_GETTER(su_ncqo, SUFLOAT, get_freq)
 {
   return self->fnor;
 }
+
+/******************************* Bulk methods ********************************/
+/*
+ * Oscillator samples are produced in blocks. In the floating-point mode,
+ * the first phasor of every block is computed exactly and the rest are
+ * obtained by rotating it by a table of block offsets. This keeps the
+ * rounding errors of the rotation bounded, and the inner loops free of
+ * dependencies between samples (so they can be vectorized).
+ */
+#define SU_NCQO_BULK_BLOCK 64
+
+enum su_ncqo_bulk_op {
+  SU_NCQO_BULK_READ,
+  SU_NCQO_BULK_MIX,
+  SU_NCQO_BULK_MIX_CONJ,
+};
+
+/* Compute the next n (<= SU_NCQO_BULK_BLOCK) samples of the oscillator */
+SUINLINE void
+__su_ncqo_read_block(
+    su_ncqo_t *self,
+    SUCOMPLEX *__restrict out,
+    const SUCOMPLEX *__restrict offsets,
+    unsigned int n)
+{
+  SUCOMPLEX base;
+  unsigned int i;
+
+#ifdef SU_NCQO_USE_PRECALC_BUFFER
+  if (self->pre_c) {
+    for (i = 0; i < n; ++i) {
+      out[i] = self->precalc->cos_buffer[self->p] + I * self->precalc->sin_buffer[self->p];
+      __su_ncqo_step_precalc(self);
+    }
+    return;
+  }
+#endif /* SU_NCQO_USE_PRECALC_BUFFER */
+
+  if (self->mode != SU_NCQO_MODE_FLOAT) {
+    for (i = 0; i < n; ++i) {
+      out[i] = __su_ncqo_lut_cos(self) + I * __su_ncqo_lut_sin(self);
+      self->acc += self->dacc;
+    }
+    return;
+  }
+
+  base = SU_C_EXP(I * self->phi);
+
+  for (i = 0; i < n; ++i)
+    out[i] = base * offsets[i];
+
+  self->phi = su_phase_adjust(self->phi + (SUFLOAT) n * self->omega);
+}
+
+SUPRIVATE void
+su_ncqo_bulk(
+    su_ncqo_t *self,
+    SUCOMPLEX *__restrict buf,
+    SUSCOUNT size,
+    enum su_ncqo_bulk_op op)
+{
+  SUCOMPLEX offsets[SU_NCQO_BULK_BLOCK];
+  SUCOMPLEX phasors[SU_NCQO_BULK_BLOCK];
+  SUCOMPLEX step;
+  SUSCOUNT p;
+  unsigned int i, n;
+
+  if (size == 0)
+    return;
+
+  if (self->mode == SU_NCQO_MODE_FLOAT) {
+    step = SU_C_EXP(I * self->omega);
+    offsets[0] = 1;
+    for (i = 1; i < SU_NCQO_BULK_BLOCK; ++i)
+      offsets[i] = offsets[i - 1] * step;
+  }
+
+  for (p = 0; p < size; p += n) {
+    n = SU_MIN(size - p, SU_NCQO_BULK_BLOCK);
+
+    switch (op) {
+      case SU_NCQO_BULK_READ:
+        __su_ncqo_read_block(self, buf + p, offsets, n);
+        break;
+
+      case SU_NCQO_BULK_MIX:
+        __su_ncqo_read_block(self, phasors, offsets, n);
+        for (i = 0; i < n; ++i)
+          buf[p + i] *= phasors[i];
+        break;
+
+      case SU_NCQO_BULK_MIX_CONJ:
+        __su_ncqo_read_block(self, phasors, offsets, n);
+        for (i = 0; i < n; ++i)
+          buf[p + i] *= SU_C_CONJ(phasors[i]);
+        break;
+    }
+  }
+
+  /* Leave the oscillator as su_ncqo_read would */
+  if (self->mode == SU_NCQO_MODE_FLOAT
+#ifdef SU_NCQO_USE_PRECALC_BUFFER
+      && !self->pre_c
+#endif /* SU_NCQO_USE_PRECALC_BUFFER */
+  ) {
+    self->cos = SU_COS(self->phi);
+    self->sin = SU_SIN(self->phi);
+    self->cos_updated = SU_TRUE;
+    self->sin_updated = SU_TRUE;
+  }
+}
+
+SU_METHOD(su_ncqo, void, read_bulk, SUCOMPLEX *out, SUSCOUNT size)
+{
+  su_ncqo_bulk(self, out, size, SU_NCQO_BULK_READ);
+}
+
+SU_METHOD(su_ncqo, void, mix_bulk, SUCOMPLEX *buf, SUSCOUNT size)
+{
+  su_ncqo_bulk(self, buf, size, SU_NCQO_BULK_MIX);
+}
+
+SU_METHOD(su_ncqo, void, mix_conj_bulk, SUCOMPLEX *buf, SUSCOUNT size)
+{
+  su_ncqo_bulk(self, buf, size, SU_NCQO_BULK_MIX_CONJ);
+}
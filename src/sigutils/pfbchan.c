@@ -0,0 +1,332 @@
+/*
+
+  Copyright (C) 2026 Gonzalo José Carracedo Carballal
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, version 3.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this program.  If not, see
+  <http://www.gnu.org/licenses/>
+
+*/
+
+#define SU_LOG_DOMAIN "pfbchan"
+
+#include <sigutils/pfbchan.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <sigutils/design.h>
+#include <sigutils/sigutils.h>
+
+/*
+ * Channel k is obtained by shifting it to baseband and filtering it with
+ * the prototype filter h of length L = P * M. Output sample m is computed
+ * right after input sample n = (m + 1) D - 1:
+ *
+ *   y_k[m] = sum_l h[l] x[n - l] e^(-j 2 pi k (n - l) / M)
+ *
+ * Splitting l = pM + r, the sum over p only depends on the branch r:
+ *
+ *   u_r[m] = sum_p h[pM + r] x[n - pM - r]
+ *   y_k[m] = e^(-j 2 pi k (n + 1) / M) sum_r u_r[m] e^(j 2 pi k (r + 1) / M)
+ *
+ * i.e. the M channels are the backward DFT of the M branch outputs, once
+ * rotated by one position. The leading factor is 1 for D = M and
+ * (-1)^(k (m + 1)) for D = M / 2.
+ */
+
+/************************* Channel methods ***********************************/
+SUPRIVATE
+SU_COLLECTOR(su_pfbchan_channel)
+{
+  if (self->buffer != NULL)
+    free(self->buffer);
+
+  free(self);
+}
+
+SUPRIVATE
+SU_INSTANCER(
+    su_pfbchan_channel,
+    const su_pfbchan_t *owner,
+    const struct sigutils_pfbchan_channel_params *params)
+{
+  su_pfbchan_channel_t *new = NULL;
+
+  SU_TRYCATCH(params->index < owner->params.channels, goto fail);
+  SU_TRYCATCH(params->on_data != NULL, goto fail);
+
+  SU_ALLOCATE_FAIL(new, su_pfbchan_channel_t);
+
+  new->params = *params;
+  new->index = -1;
+
+  SU_ALLOCATE_MANY_FAIL(new->buffer, owner->params.block_size, SUCOMPLEX);
+
+  return new;
+
+fail:
+  if (new != NULL)
+    su_pfbchan_channel_destroy(new);
+
+  return NULL;
+}
+
+/*********************** Channelizer methods *********************************/
+SU_COLLECTOR(su_pfbchan)
+{
+  unsigned int i;
+
+  for (i = 0; i < self->channel_count; ++i)
+    if (self->channel_list[i] != NULL)
+      su_pfbchan_channel_destroy(self->channel_list[i]);
+
+  if (self->channel_list != NULL)
+    free(self->channel_list);
+
+  if (self->plan != NULL)
+    su_lib_release_plan(self->plan);
+
+  if (self->branch != NULL)
+    SU_FFTW(_free)(self->branch);
+
+  if (self->output != NULL)
+    SU_FFTW(_free)(self->output);
+
+  if (self->history != NULL)
+    free(self->history);
+
+  if (self->h != NULL)
+    free(self->h);
+
+  free(self);
+}
+
+SUPRIVATE
+SU_METHOD(su_pfbchan, SUBOOL, init_prototype)
+{
+  const SUFLOAT *h = NULL;
+  unsigned int i;
+  SUFLOAT sum = 0;
+
+  SU_TRYCATCH(
+      h = su_design_brickwall_lp(
+          self->params.bw / self->params.channels,
+          self->taps),
+      return SU_FALSE);
+
+  /* Unity gain in the passband */
+  for (i = 0; i < self->taps; ++i)
+    sum += h[i];
+
+  for (i = 0; i < self->taps; ++i)
+    self->h[i] = h[i] / sum;
+
+  su_design_release(h);
+
+  return SU_TRUE;
+}
+
+SU_INSTANCER(su_pfbchan, const struct sigutils_pfbchan_params *params)
+{
+  su_pfbchan_t *new = NULL;
+  unsigned int flags = su_lib_fftw_strategy();
+  SUSCOUNT size;
+
+  if (params->channels < 2) {
+    SU_ERROR("At least two channels are required\n");
+    goto fail;
+  }
+
+  if (params->oversample && (params->channels & 1)) {
+    SU_ERROR("Oversampled filter banks require an even number of channels\n");
+    goto fail;
+  }
+
+  SU_TRYCATCH(params->taps_per_branch > 0, goto fail);
+  SU_TRYCATCH(params->block_size > 0, goto fail);
+  SU_TRYCATCH(params->bw > 0, goto fail);
+
+  SU_ALLOCATE_FAIL(new, su_pfbchan_t);
+
+  new->params = *params;
+  new->taps = params->channels * params->taps_per_branch;
+  new->decimation =
+      params->oversample ? params->channels >> 1 : params->channels;
+
+  SU_ALLOCATE_MANY_FAIL(new->h, new->taps, SUFLOAT);
+  SU_ALLOCATE_MANY_FAIL(new->history, 2 * new->taps, SUCOMPLEX);
+
+  SU_TRY_FAIL(su_pfbchan_init_prototype(new));
+
+  size = params->channels * sizeof(SU_FFTW(_complex));
+
+  SU_TRY_FAIL(new->branch = SU_FFTW(_malloc)(size));
+  SU_TRY_FAIL(new->output = SU_FFTW(_malloc)(params->block_size * size));
+
+  memset(new->branch, 0, size);
+  memset(new->output, 0, params->block_size * size);
+
+  /* FFTs are written at arbitrary rows of the output buffer */
+  if (size % 64 != 0)
+    flags |= FFTW_UNALIGNED;
+
+  SU_TRY_FAIL(
+      new->plan = su_lib_acquire_dft_plan(
+          params->channels,
+          1,
+          new->branch,
+          new->output,
+          FFTW_BACKWARD,
+          flags));
+
+  return new;
+
+fail:
+  if (new != NULL)
+    su_pfbchan_destroy(new);
+
+  return NULL;
+}
+
+SUPRIVATE
+SU_METHOD(su_pfbchan, SUBOOL, deliver)
+{
+  unsigned int i, j;
+  unsigned int k;
+  unsigned int M = self->params.channels;
+  su_pfbchan_channel_t *channel;
+  SUBOOL flip;
+  SUBOOL ok = SU_TRUE;
+
+  for (i = 0; i < self->channel_count; ++i) {
+    if ((channel = self->channel_list[i]) == NULL)
+      continue;
+
+    k = channel->params.index;
+
+    /* Odd channels alternate sign in the oversampled case */
+    flip = self->params.oversample && (k & 1);
+
+    if (flip) {
+      for (j = 0; j < self->out_p; ++j)
+        channel->buffer[j] = ((self->out_count + j) & 1)
+                                 ? self->output[j * M + k]
+                                 : -self->output[j * M + k];
+    } else {
+      for (j = 0; j < self->out_p; ++j)
+        channel->buffer[j] = self->output[j * M + k];
+    }
+
+    ok = (channel->params.on_data)(
+        channel,
+        channel->params.privdata,
+        channel->buffer,
+        self->out_p) && ok;
+  }
+
+  self->out_count += self->out_p;
+  self->out_p = 0;
+
+  return ok;
+}
+
+SUINLINE void
+__su_pfbchan_compute_branches(su_pfbchan_t *self)
+{
+  const SUCOMPLEX *x = self->history + self->p; /* x[taps - 1] is newest */
+  unsigned int M = self->params.channels;
+  unsigned int L = self->taps;
+  unsigned int r, l;
+  SUCOMPLEX acc;
+
+  for (r = 0; r < M; ++r) {
+    acc = 0;
+    for (l = r; l < L; l += M)
+      acc += self->h[l] * x[L - 1 - l];
+    self->branch[r + 1 < M ? r + 1 : 0] = acc;
+  }
+}
+
+SU_METHOD(su_pfbchan, SUBOOL, feed_bulk, const SUCOMPLEX *buf, SUSCOUNT size)
+{
+  SUSCOUNT i;
+  SUBOOL ok = SU_TRUE;
+
+  for (i = 0; i < size; ++i) {
+    self->history[self->p] = self->history[self->p + self->taps] = buf[i];
+
+    if (++self->p == self->taps)
+      self->p = 0;
+
+    if (++self->fill == self->decimation) {
+      self->fill = 0;
+
+      __su_pfbchan_compute_branches(self);
+
+      SU_FFTW(_execute_dft)(
+          self->plan,
+          self->branch,
+          self->output + self->out_p * self->params.channels);
+
+      if (++self->out_p == self->params.block_size)
+        ok = su_pfbchan_deliver(self) && ok;
+    }
+  }
+
+  return ok;
+}
+
+SU_METHOD(
+    su_pfbchan,
+    su_pfbchan_channel_t *,
+    open_channel,
+    const struct sigutils_pfbchan_channel_params *params)
+{
+  su_pfbchan_channel_t *new = NULL;
+  int index;
+
+  SU_MAKE_FAIL(new, su_pfbchan_channel, self, params);
+
+  SU_TRYC_FAIL(index = PTR_LIST_APPEND_CHECK(self->channel, new));
+
+  new->index = index;
+
+  return new;
+
+fail:
+  if (new != NULL)
+    su_pfbchan_channel_destroy(new);
+
+  return NULL;
+}
+
+SU_METHOD(
+    su_pfbchan,
+    SUBOOL,
+    close_channel,
+    su_pfbchan_channel_t *channel)
+{
+  SU_TRYCATCH(channel->index >= 0, return SU_FALSE);
+
+  SU_TRYCATCH(
+      (unsigned int) channel->index < self->channel_count,
+      return SU_FALSE);
+
+  SU_TRYCATCH(self->channel_list[channel->index] == channel, return SU_FALSE);
+
+  self->channel_list[channel->index] = NULL;
+
+  su_pfbchan_channel_destroy(channel);
+
+  return SU_TRUE;
+}
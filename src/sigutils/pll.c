@@ -21,10 +21,9 @@
 
 #include <string.h>
 
-#include <sigutils/coef.h>
+#include <sigutils/design.h>
 #include <sigutils/log.h>
 #include <sigutils/sampling.h>
-#include <sigutils/taps.h>
 #include <sigutils/types.h>
 
 SU_DESTRUCTOR(su_pll)
@@ -92,6 +91,8 @@ SU_CONSTRUCTOR(
 {
   SUFLOAT *b = NULL;
   SUFLOAT *a = NULL;
+  const SUFLOAT *design = NULL;
+  const SUFLOAT *ccof = NULL;
   SUFLOAT scaling;
   unsigned int i = 0;
 
@@ -110,22 +111,28 @@ SU_CONSTRUCTOR(
   if (arm_order == 0)
     arm_order = 1;
 
-  if (arm_order == 1 || arm_order >= SU_COSTAS_FIR_ORDER_THRESHOLD) {
+  /* Coefficients come from the design cache whenever possible */
+  if (arm_order == 1) {
     SU_ALLOCATE_MANY_FAIL(b, arm_order, SUFLOAT);
-
-    if (arm_order == 1)
-      b[0] = 1; /* No filtering */
-    else
-      su_taps_brickwall_lp_init(b, arm_bw, arm_order);
+    b[0] = 1; /* No filtering */
+  } else if (arm_order >= SU_COSTAS_FIR_ORDER_THRESHOLD) {
+    SU_TRY_FAIL(design = su_design_brickwall_lp(arm_bw, arm_order));
+    b = (SUFLOAT *)design;
   } else {
     /* If arm filter order is small, try to build a IIR filter */
-    SU_TRY_FAIL(a = su_dcof_bwlp(arm_order - 1, arm_bw));
-    SU_TRY_FAIL(b = su_ccof_bwlp(arm_order - 1));
+    SU_TRY_FAIL(design = su_design_dcof_bwlp(arm_order - 1, arm_bw));
+    SU_TRY_FAIL(ccof = su_design_ccof_bwlp(arm_order - 1));
+    SU_ALLOCATE_MANY_FAIL(b, arm_order, SUFLOAT);
 
-    scaling = su_sf_bwlp(arm_order - 1, arm_bw);
+    scaling = su_design_sf_bwlp(arm_order - 1, arm_bw);
 
     for (i = 0; i < arm_order; ++i)
-      b[i] *= scaling;
+      b[i] = ccof[i] * scaling;
+
+    su_design_release(ccof);
+    ccof = NULL;
+
+    a = (SUFLOAT *)design;
   }
 
   SU_TRY_FAIL(__su_iir_filt_init(
@@ -136,6 +143,8 @@ SU_CONSTRUCTOR(
       b,
       SU_FALSE));
 
+  self->af.design = design;
+
   b = NULL;
   a = NULL;
 
@@ -144,11 +153,11 @@ SU_CONSTRUCTOR(
 fail:
   SU_DESTRUCT(su_costas, self);
 
-  if (b != NULL)
+  if (b != NULL && b != design)
     free(b);
 
-  if (a != NULL)
-    free(a);
+  su_design_release(design);
+  su_design_release(ccof);
 
   return SU_FALSE;
 }
@@ -0,0 +1,230 @@
+/*
+
+  Copyright (C) 2026 Gonzalo José Carracedo Carballal
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, version 3.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this program.  If not, see
+  <http://www.gnu.org/licenses/>
+
+*/
+
+#define SU_LOG_DOMAIN "refcache"
+
+#include <sigutils/refcache.h>
+
+#include <string.h>
+
+#include <sigutils/log.h>
+
+SU_CONSTRUCTOR(su_refcache, const struct sigutils_refcache_class *classdata)
+{
+  memset(self, 0, sizeof(su_refcache_t));
+
+  self->classdata = classdata;
+
+  return pthread_mutex_init(&self->mutex, NULL) == 0;
+}
+
+SU_DESTRUCTOR(su_refcache)
+{
+  unsigned int i;
+
+  for (i = 0; i < self->entry_count; ++i)
+    if (self->entry_list[i] != NULL)
+      (self->classdata->destroy)(self->entry_list[i]);
+
+  if (self->entry_list != NULL)
+    free(self->entry_list);
+
+  pthread_mutex_destroy(&self->mutex);
+
+  memset(self, 0, sizeof(su_refcache_t));
+}
+
+/*
+ * Looks up an object matching key and takes a reference to it. Must be
+ * called with the cache mutex held.
+ */
+SUPRIVATE
+SU_METHOD(
+    su_refcache,
+    struct sigutils_refcache_entry *,
+    lookup,
+    const void *key)
+{
+  struct sigutils_refcache_entry *entry;
+  unsigned int i;
+
+  for (i = 0; i < self->entry_count; ++i) {
+    entry = self->entry_list[i];
+    if (entry != NULL && (self->classdata->match)(entry, key)) {
+      ++entry->refcount;
+      return entry;
+    }
+  }
+
+  return NULL;
+}
+
+/*
+ * Detaches the least recently used idle object if the cache holds too
+ * many of them. Must be called with the cache mutex held. The caller
+ * destroys it.
+ */
+SUPRIVATE
+SU_METHOD(su_refcache, struct sigutils_refcache_entry *, evict)
+{
+  struct sigutils_refcache_entry *entry;
+  unsigned int i, idle = 0, oldest = 0;
+  SUSCOUNT idle_size = 0;
+  SUBOOL found = SU_FALSE;
+
+  for (i = 0; i < self->entry_count; ++i) {
+    entry = self->entry_list[i];
+    if (entry != NULL && entry->refcount == 0) {
+      ++idle;
+      idle_size += entry->size;
+      if (!found
+          || entry->last_used < self->entry_list[oldest]->last_used) {
+        oldest = i;
+        found  = SU_TRUE;
+      }
+    }
+  }
+
+  if (idle <= self->classdata->max_idle
+      && idle_size <= self->classdata->max_idle_size)
+    return NULL;
+
+  entry = self->entry_list[oldest];
+  self->entry_list[oldest] = NULL;
+
+  --self->stats.entries;
+  self->stats.size -= entry->size;
+
+  return entry;
+}
+
+/*
+ * Objects are created without holding the cache mutex, so two threads
+ * may end up creating the same one. In that case, the first one to make
+ * it to the cache wins and the other one is destroyed.
+ */
+SU_METHOD(
+    su_refcache,
+    const struct sigutils_refcache_entry *,
+    acquire,
+    const void *key)
+{
+  struct sigutils_refcache_entry *entry = NULL;
+  struct sigutils_refcache_entry *cached = NULL;
+  SUBOOL mutex_acquired = SU_FALSE;
+
+  SU_TRYZ(pthread_mutex_lock(&self->mutex));
+  mutex_acquired = SU_TRUE;
+
+  if ((cached = su_refcache_lookup(self, key)) != NULL) {
+    ++self->stats.hits;
+    goto done;
+  }
+
+  ++self->stats.misses;
+
+  pthread_mutex_unlock(&self->mutex);
+  mutex_acquired = SU_FALSE;
+
+  SU_TRY(entry = (self->classdata->create)(key));
+
+  SU_TRYZ(pthread_mutex_lock(&self->mutex));
+  mutex_acquired = SU_TRUE;
+
+  if ((cached = su_refcache_lookup(self, key)) != NULL)
+    goto done;
+
+  SU_TRYC(PTR_LIST_APPEND_CHECK(self->entry, entry));
+
+  entry->refcount = 1;
+  ++self->stats.entries;
+  self->stats.size += entry->size;
+
+  cached = entry;
+  entry  = NULL;
+
+done:
+  if (mutex_acquired)
+    pthread_mutex_unlock(&self->mutex);
+
+  if (entry != NULL)
+    (self->classdata->destroy)(entry);
+
+  return cached;
+}
+
+SU_METHOD(su_refcache, SUBOOL, release, const void *data)
+{
+  struct sigutils_refcache_entry *entry;
+  struct sigutils_refcache_entry *evicted = NULL;
+  unsigned int i;
+  SUBOOL found = SU_FALSE;
+
+  SU_TRYZ(pthread_mutex_lock(&self->mutex));
+
+  for (i = 0; i < self->entry_count; ++i) {
+    entry = self->entry_list[i];
+    if (entry != NULL && entry->data == data) {
+      if (entry->refcount > 0 && --entry->refcount == 0) {
+        entry->last_used = ++self->tick;
+        evicted = su_refcache_evict(self);
+      }
+
+      found = SU_TRUE;
+      break;
+    }
+  }
+
+  pthread_mutex_unlock(&self->mutex);
+
+  /* Destroyed out of the cache mutex, one at a time */
+  while (evicted != NULL) {
+    (self->classdata->destroy)(evicted);
+
+    SU_TRYZ(pthread_mutex_lock(&self->mutex));
+    evicted = su_refcache_evict(self);
+    pthread_mutex_unlock(&self->mutex);
+  }
+
+done:
+  return found;
+}
+
+SU_METHOD(
+    su_refcache,
+    void,
+    get_stats,
+    struct sigutils_refcache_stats *stats)
+{
+  unsigned int i;
+
+  if (pthread_mutex_lock(&self->mutex) != 0) {
+    memset(stats, 0, sizeof(struct sigutils_refcache_stats));
+    return;
+  }
+
+  *stats = self->stats;
+
+  stats->idle = 0;
+  for (i = 0; i < self->entry_count; ++i)
+    if (self->entry_list[i] != NULL && self->entry_list[i]->refcount == 0)
+      ++stats->idle;
+
+  pthread_mutex_unlock(&self->mutex);
+}
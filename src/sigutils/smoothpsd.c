@@ -21,7 +21,7 @@
 
 #include <sigutils/sigutils.h>
 #include <sigutils/smoothpsd.h>
-#include <sigutils/taps.h>
+#include <sigutils/window.h>
 #include <string.h>
 
 #if defined(_SU_SINGLE_PRECISION) && HAVE_VOLK
@@ -70,7 +70,7 @@ SU_METHOD(su_smoothpsd, SUBOOL, exec_fft)
   SUFLOAT wsizeinv = 1. / (self->params.fft_size * self->nominal_rate);
 
   /* Execute FFT */
-  SU_FFTW(_execute(self->fft_plan));
+  SU_FFTW(_execute_dft(self->fft_plan, self->fft, self->fft));
 
   /* Keep real coefficients only */
 #ifdef SU_USE_VOLK
@@ -210,16 +210,16 @@ SU_METHOD(
     set_params,
     const struct sigutils_smoothpsd_params *params)
 {
-  unsigned int i;
   void *tmp = NULL;
   SUBOOL mutex_acquired = SU_FALSE;
 
-  SU_FFTW(_complex) *window_func = NULL;
+  const SU_FFTW(_complex) *window_func = NULL;
   SU_FFTW(_complex) *buffer = NULL;
   SU_FFTW(_complex) *fftbuf = NULL;
   SU_FFTW(_plan) fft_plan = NULL;
 
-  SUBOOL refresh_window_func = params->window != self->params.window;
+  SUBOOL refresh_window_func = params->window != self->params.window
+                               || params->fft_size != self->params.fft_size;
   SUBOOL ok = SU_FALSE;
 
   /*
@@ -227,14 +227,14 @@ SU_METHOD(
    * makes the initialization of the fft particularly slow and we can detach
    * it from the modification of the current object.
    */
-  if (params->fft_size != self->params.fft_size) {
-    if ((window_func =
-             SU_FFTW(_malloc)(params->fft_size * sizeof(SU_FFTW(_complex))))
-        == NULL) {
-      SU_ERROR("cannot allocate memory for window\n");
-      goto done;
-    }
+  if (refresh_window_func)
+    SU_TRYCATCH(
+        window_func = su_window_acquire_complex(
+            (enum sigutils_window_kind)params->window,
+            params->fft_size),
+        goto done);
 
+  if (params->fft_size != self->params.fft_size) {
     if ((buffer =
              SU_FFTW(_malloc)(params->fft_size * sizeof(SU_FFTW(_complex))))
         == NULL) {
@@ -254,8 +254,9 @@ SU_METHOD(
     memset(fftbuf, 0, params->fft_size * sizeof(SU_FFTW(_complex)));
 
     /* Direct FFT plan */
-    if ((fft_plan = su_lib_plan_dft_1d(
+    if ((fft_plan = su_lib_acquire_dft_plan(
              params->fft_size,
+             1,
              fftbuf,
              fftbuf,
              FFTW_FORWARD,
@@ -268,14 +269,11 @@ SU_METHOD(
     SU_TRYZ(pthread_mutex_lock(&self->mutex));
     mutex_acquired = SU_TRUE;
 
-    _SWAP(window_func, self->window_func);
     _SWAP(buffer, self->buffer);
     _SWAP(fftbuf, self->fft);
     _SWAP(fft_plan, self->fft_plan);
 
     self->p = 0;
-
-    refresh_window_func = SU_TRUE;
   }
 
   if (!mutex_acquired) {
@@ -286,42 +284,9 @@ SU_METHOD(
   self->params = *params;
 
   if (refresh_window_func) {
-    for (i = 0; i < self->params.fft_size; ++i)
-      self->window_func[i] = 1;
-
-    switch (self->params.window) {
-      case SU_CHANNEL_DETECTOR_WINDOW_NONE:
-        /* Do nothing. */
-        break;
-
-      case SU_CHANNEL_DETECTOR_WINDOW_HAMMING:
-        su_taps_apply_hamming_complex(self->window_func, self->params.fft_size);
-        break;
-
-      case SU_CHANNEL_DETECTOR_WINDOW_HANN:
-        su_taps_apply_hann_complex(self->window_func, self->params.fft_size);
-        break;
-
-      case SU_CHANNEL_DETECTOR_WINDOW_FLAT_TOP:
-        su_taps_apply_flat_top_complex(
-            self->window_func,
-            self->params.fft_size);
-        break;
-
-      case SU_CHANNEL_DETECTOR_WINDOW_BLACKMANN_HARRIS:
-        su_taps_apply_blackmann_harris_complex(
-            self->window_func,
-            self->params.fft_size);
-        break;
-
-      default:
-        /*
-         * This surely will generate thousands of messages, but it should
-         * never happen either
-         */
-        SU_WARNING("Unsupported window function %d\n", self->params.window);
-        goto done;
-    }
+    tmp = (void *)self->window_func;
+    self->window_func = window_func;
+    window_func = tmp;
   }
 
   /* We use the sample rate as timebase for all calculations */
@@ -344,10 +309,9 @@ done:
     (void)pthread_mutex_unlock(&self->mutex);
 
   if (fft_plan != NULL)
-    SU_FFTW(_destroy_plan)(fft_plan);
+    su_lib_release_plan(fft_plan);
 
-  if (window_func != NULL)
-    SU_FFTW(_free)(window_func);
+  su_window_release(window_func);
 
   if (buffer != NULL)
     SU_FFTW(_free)(buffer);
@@ -364,10 +328,9 @@ SU_COLLECTOR(su_smoothpsd)
     pthread_mutex_destroy(&self->mutex);
 
   if (self->fft_plan != NULL)
-    SU_FFTW(_destroy_plan)(self->fft_plan);
+    su_lib_release_plan(self->fft_plan);
 
-  if (self->window_func != NULL)
-    SU_FFTW(_free)(self->window_func);
+  su_window_release(self->window_func);
 
   if (self->buffer != NULL)
     SU_FFTW(_free)(self->buffer);
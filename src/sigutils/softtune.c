@@ -46,6 +46,8 @@ su_softtuner_init(
     su_softtuner_t *tuner,
     const struct sigutils_softtuner_params *params)
 {
+  SUFLOAT fc;
+
   assert(params->samp_rate > 0);
   assert(params->decimation > 0);
 
@@ -58,11 +60,31 @@ su_softtuner_init(
       su_stream_init(&tuner->output, SU_BLOCK_STREAM_BUFFER_SIZE),
       goto fail);
 
-  su_ncqo_init_fixed(
-      &tuner->lo,
-      SU_ABS2NORM_FREQ(params->samp_rate, params->fc));
+  su_channel_detector_set_fc(tuner, params->fc);
+
+  if (params->polyphase && params->decimation > 1) {
+    /*
+     * The decimating FIR does both the antialiasing and the decimation.
+     * Its cutoff is placed below the output Nyquist frequency, so that
+     * the transition band ends there: whatever lies beyond it is more
+     * than 50 dB down before folding into the output band.
+     */
+    fc = (1 - SU_SOFTTUNER_POLYPHASE_TRANSITION) / params->decimation;
+    if (params->bw > 0.0)
+      fc = SU_MIN(
+          fc,
+          .5 * SU_ABS2NORM_FREQ(params->samp_rate, params->bw)
+              * SU_SOFTTUNER_ANTIALIAS_EXTRA_BW);
 
-  if (params->bw > 0.0) {
+    SU_TRYCATCH(
+        su_decim_init_lowpass(
+            &tuner->decim,
+            params->decimation,
+            SU_SOFTTUNER_POLYPHASE_TAPS_PER_PHASE,
+            fc),
+        goto fail);
+    tuner->polyphase = SU_TRUE;
+  } else if (params->bw > 0.0) {
     SU_TRYCATCH(
         su_iir_bwlpf_init(
             &tuner->antialias,
@@ -85,7 +107,8 @@ SUSCOUNT
 su_softtuner_feed(su_softtuner_t *tuner, const SUCOMPLEX *input, SUSCOUNT size)
 {
   SUSCOUNT i = 0;
-  SUCOMPLEX x;
+  SUSCOUNT j, chunk;
+  SUCOMPLEX x[SU_SOFTTUNER_MIX_BLOCK];
   SUSCOUNT avail;
   SUCOMPLEX *buf;
   SUSCOUNT n = 0;
@@ -99,24 +122,48 @@ su_softtuner_feed(su_softtuner_t *tuner, const SUCOMPLEX *input, SUSCOUNT size)
 
   buf[0] = 0;
 
-  for (i = 0; i < size && n < avail; ++i) {
+  /*
+   * The LO is applied in blocks, so we must not take more samples than
+   * those fitting in the output buffer.
+   */
+  if (tuner->params.decimation > 1)
+    size = SU_MIN(size, avail * tuner->params.decimation - tuner->decim_ptr);
+  else
+    size = SU_MIN(size, avail);
+
+  while (i < size) {
+    chunk = SU_MIN(size - i, SU_SOFTTUNER_MIX_BLOCK);
+
     /* Carrier centering. Must happen *before* decimation */
-    x = input[i] * SU_C_CONJ(su_ncqo_read(&tuner->lo));
+    memcpy(x, input + i, chunk * sizeof(SUCOMPLEX));
+    su_ncqo_mix_conj_bulk(&tuner->lo, x, chunk);
+
+    if (tuner->polyphase) {
+      n += su_decim_feed_bulk(&tuner->decim, x, chunk, buf + n);
+      i += chunk;
+      continue;
+    }
 
     if (tuner->filtered)
-      x = su_iir_filt_feed(&tuner->antialias, x);
+      for (j = 0; j < chunk; ++j)
+        x[j] = su_iir_filt_feed(&tuner->antialias, x[j]);
 
     if (tuner->params.decimation > 1) {
-      if (++tuner->decim_ptr < tuner->params.decimation) {
-        buf[n] += tuner->avginv * x;
-      } else {
-        if (++n < avail)
-          buf[n] = 0;
-        tuner->decim_ptr = 0; /* Reset decimation pointer */
+      for (j = 0; j < chunk; ++j) {
+        if (++tuner->decim_ptr < tuner->params.decimation) {
+          buf[n] += tuner->avginv * x[j];
+        } else {
+          if (++n < avail)
+            buf[n] = 0;
+          tuner->decim_ptr = 0; /* Reset decimation pointer */
+        }
       }
     } else {
-      buf[n++] = x;
+      memcpy(buf + n, x, chunk * sizeof(SUCOMPLEX));
+      n += chunk;
     }
+
+    i += chunk;
   }
 
   su_stream_advance_contiguous(&tuner->output, n);
@@ -148,7 +195,12 @@ su_softtuner_finalize(su_softtuner_t *tuner)
   if (tuner->filtered)
     su_iir_filt_finalize(&tuner->antialias);
 
+  if (tuner->polyphase)
+    su_decim_finalize(&tuner->decim);
+
   su_stream_finalize(&tuner->output);
 
+  su_ncqo_finalize(&tuner->lo);
+
   memset(tuner, 0, sizeof(su_softtuner_t));
 }
@@ -45,10 +45,10 @@ su_apt_decoder_correlate(
   SUFLOAT mean, sum;
 
   /* Correlate */
-  SU_FFTW(_execute)(self->direct_plan);
+  SU_FFTW(_execute_dft)(self->direct_plan, self->samp_buffer, self->corr_fft);
   for (i = 0; i < SU_APT_BUFF_LEN; ++i)
     self->corr_fft[i] *= SU_C_CONJ(pat[i]);
-  SU_FFTW(_execute)(self->reverse_plan);
+  SU_FFTW(_execute_dft)(self->reverse_plan, self->corr_fft, self->corr_fft);
 
   /* Find pulse. This is actually a first guess. */
   max = SU_APT_MIN_LEVEL;
@@ -501,8 +501,9 @@ su_apt_decoder_new(SUFLOAT fs, const struct sigutils_apt_decoder_callbacks *cb)
   bw = SU_ABS2NORM_FREQ(fs, SU_APT_AM_BANDWIDTH);
 
   SU_TRYCATCH(
-      pattern_plan = su_lib_plan_dft_1d(
+      pattern_plan = su_lib_acquire_dft_plan(
           SU_APT_BUFF_LEN,
+          1,
           new->sync_fft,
           new->sync_fft,
           FFTW_FORWARD,
@@ -510,8 +511,9 @@ su_apt_decoder_new(SUFLOAT fs, const struct sigutils_apt_decoder_callbacks *cb)
       goto done);
 
   SU_TRYCATCH(
-      new->direct_plan = su_lib_plan_dft_1d(
+      new->direct_plan = su_lib_acquire_dft_plan(
           SU_APT_BUFF_LEN,
+          1,
           new->samp_buffer,
           new->corr_fft,
           FFTW_FORWARD,
@@ -519,8 +521,9 @@ su_apt_decoder_new(SUFLOAT fs, const struct sigutils_apt_decoder_callbacks *cb)
       goto done);
 
   SU_TRYCATCH(
-      new->reverse_plan = su_lib_plan_dft_1d(
+      new->reverse_plan = su_lib_acquire_dft_plan(
           SU_APT_BUFF_LEN,
+          1,
           new->corr_fft,
           new->corr_fft,
           FFTW_BACKWARD,
@@ -554,7 +557,7 @@ su_apt_decoder_new(SUFLOAT fs, const struct sigutils_apt_decoder_callbacks *cb)
     new->sync_fft[i] = (i >= 4 && j < 3) ? kinv : -kinv;
   }
 
-  SU_FFTW(_execute)(pattern_plan);
+  SU_FFTW(_execute_dft)(pattern_plan, new->sync_fft, new->sync_fft);
 
   ok = SU_TRUE;
 
@@ -567,7 +570,7 @@ done:
   }
 
   if (pattern_plan != NULL)
-    SU_FFTW(_destroy_plan)(pattern_plan);
+    su_lib_release_plan(pattern_plan);
 
   return new;
 }
@@ -576,10 +579,10 @@ void
 su_apt_decoder_destroy(su_apt_decoder_t *self)
 {
   if (self->reverse_plan != NULL)
-    SU_FFTW(_destroy_plan)(self->reverse_plan);
+    su_lib_release_plan(self->reverse_plan);
 
   if (self->direct_plan != NULL)
-    SU_FFTW(_destroy_plan)(self->direct_plan);
+    su_lib_release_plan(self->direct_plan);
 
   su_apt_decoder_clear_image(self);
 
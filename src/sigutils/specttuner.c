@@ -26,7 +26,7 @@
 
 #include <sigutils/sigutils.h>
 #include <sigutils/sampling.h>
-#include <sigutils/taps.h>
+#include <sigutils/window.h>
 
 #ifdef SU_USE_VOLK
 #  define calloc su_volk_calloc
@@ -50,32 +50,36 @@ su_volk_calloc(size_t nmemb, size_t size)
 }
 #endif /* SU_USE_VOLK */
 
+#define _SWAP(a, b, tmp) \
+  tmp = a;                \
+  a = b;                  \
+  b = tmp;
+
 SUPRIVATE
 SU_COLLECTOR(su_specttuner_channel)
 {
-  if (self->plan[SU_SPECTTUNER_STATE_EVEN] != NULL)
-    SU_FFTW(_destroy_plan)(self->plan[SU_SPECTTUNER_STATE_EVEN]);
-
-  if (self->plan[SU_SPECTTUNER_STATE_ODD] != NULL)
-    SU_FFTW(_destroy_plan)(self->plan[SU_SPECTTUNER_STATE_ODD]);
+  if (self->tail != NULL)
+    SU_FFTW(_free)(self->tail);
 
-  if (self->ifft[SU_SPECTTUNER_STATE_EVEN] != NULL)
-    SU_FFTW(_free)(self->ifft[SU_SPECTTUNER_STATE_EVEN]);
+  su_window_release(self->window);
 
-  if (self->ifft[SU_SPECTTUNER_STATE_ODD] != NULL)
-    SU_FFTW(_free)(self->ifft[SU_SPECTTUNER_STATE_ODD]);
+  if (self->phase != NULL)
+    SU_FFTW(_free)(self->phase);
 
-  if (self->fft != NULL)
-    SU_FFTW(_free)(self->fft);
+  if (self->seed_plan != NULL)
+    su_lib_release_plan(self->seed_plan);
 
-  if (self->window != NULL)
-    SU_FFTW(_free)(self->window);
+  if (self->filter != NULL)
+    su_specttuner_filter_cache_release(self->filter->cache, self->filter);
 
-  if (self->forward != NULL)
-    SU_FFTW(_destroy_plan)(self->forward);
+  free(self);
+}
 
-  if (self->backward != NULL)
-    SU_FFTW(_destroy_plan)(self->backward);
+/**************************** Filter cache **********************************/
+SUPRIVATE void
+su_specttuner_filter_destroy(struct sigutils_refcache_entry *header)
+{
+  su_specttuner_filter_t *self = (su_specttuner_filter_t *)header;
 
   if (self->h != NULL)
     SU_FFTW(_free)(self->h);
@@ -83,84 +87,197 @@ SU_COLLECTOR(su_specttuner_channel)
   free(self);
 }
 
+SUPRIVATE SUBOOL
+su_specttuner_filter_match(
+    const struct sigutils_refcache_entry *header,
+    const void *key)
+{
+  const su_specttuner_filter_t *self = (const su_specttuner_filter_t *)header;
+  const su_specttuner_filter_t *k = (const su_specttuner_filter_t *)key;
+
+  return self->halfw == k->halfw && self->k == k->k;
+}
+
 SUPRIVATE
-SU_METHOD_CONST(
-    su_specttuner,
+SU_METHOD(
+    su_specttuner_filter_cache,
     void,
-    update_channel_filter,
-    su_specttuner_channel_t *channel)
+    compute_response,
+    su_specttuner_filter_t *filter)
 {
   SUCOMPLEX tmp;
-  unsigned int window_size = self->params.window_size;
+  SUCOMPLEX *h = filter->h;
+  unsigned int window_size = self->window_size;
   unsigned int window_half = window_size / 2;
   unsigned int i;
 
   /* First step: Setup ideal filter response */
-  memset(channel->h, 0, sizeof(SUCOMPLEX) * window_size);
+  memset(h, 0, sizeof(SUCOMPLEX) * window_size);
 
-  for (i = 0; i < channel->halfw; ++i) {
-    channel->h[i] = 1;
-    channel->h[window_size - i - 1] = 1;
+  for (i = 0; i < filter->halfw; ++i) {
+    h[i] = 1;
+    h[window_size - i - 1] = 1;
   }
 
   /* Second step: switch to time domain */
-  SU_FFTW(_execute)(channel->backward);
+  SU_FFTW(_execute_dft)(self->backward, h, h);
 
   /* Third step: recenter coefficients to apply window function */
   for (i = 0; i < window_half; ++i) {
-    tmp = channel->h[i];
-    channel->h[i] = channel->k * channel->h[window_half + i];
-    channel->h[window_half + i] = channel->k * tmp;
+    tmp = h[i];
+    h[i] = filter->k * h[window_half + i];
+    h[window_half + i] = filter->k * tmp;
   }
 
   /* Fourth step: apply Window function */
-  su_taps_apply_blackmann_harris_complex(channel->h, window_size);
+  for (i = 0; i < window_size; ++i)
+    h[i] *= self->window[i];
 
   /* Fifth step: recenter back */
   for (i = 0; i < window_half; ++i) {
-    tmp = channel->h[i];
-    channel->h[i] = channel->h[window_half + i];
-    channel->h[window_half + i] = tmp;
+    tmp = h[i];
+    h[i] = h[window_half + i];
+    h[window_half + i] = tmp;
   }
 
   /* Sixth step: move back to frequency domain */
-  SU_FFTW(_execute)(channel->forward);
+  SU_FFTW(_execute_dft)(self->forward, h, h);
 }
 
-SUPRIVATE
-SU_METHOD_CONST(
-    su_specttuner,
-    SUBOOL,
-    init_filter_response,
-    su_specttuner_channel_t *channel)
+/*
+ * Responses are computed without holding the cache lock, as channels may
+ * be opened from several threads. Plans are only executed here.
+ */
+SUPRIVATE struct sigutils_refcache_entry *
+su_specttuner_filter_create(const void *key)
 {
-  SUBOOL ok = SU_FALSE;
-  unsigned int window_size = self->params.window_size;
+  const su_specttuner_filter_t *k = (const su_specttuner_filter_t *)key;
+  su_specttuner_filter_t *new = NULL;
+
+  SU_ALLOCATE_FAIL(new, su_specttuner_filter_t);
+
+  new->header.data = new;
+  new->cache = k->cache;
+  new->halfw = k->halfw;
+  new->k     = k->k;
+
+  SU_TRY_FAIL(
+      new->h = SU_FFTW(_malloc)(
+          k->cache->window_size * sizeof(SU_FFTW(_complex))));
+
+  su_specttuner_filter_cache_compute_response(k->cache, new);
 
-  /* Backward plan */
-  SU_TRY(
-      channel->forward = su_lib_plan_dft_1d(
+  return &new->header;
+
+fail:
+  if (new != NULL)
+    su_specttuner_filter_destroy(&new->header);
+
+  return NULL;
+}
+
+/* Responses are only kept while some channel uses them */
+SUPRIVATE const struct sigutils_refcache_class g_filter_response_class = {
+    su_specttuner_filter_match,
+    su_specttuner_filter_create,
+    su_specttuner_filter_destroy,
+    0,
+    0};
+
+SU_COLLECTOR(su_specttuner_filter_cache)
+{
+  if (self->responses_init)
+    su_refcache_finalize(&self->responses);
+
+  if (self->forward != NULL)
+    su_lib_release_plan(self->forward);
+
+  if (self->backward != NULL)
+    su_lib_release_plan(self->backward);
+
+  if (self->buffer != NULL)
+    SU_FFTW(_free)(self->buffer);
+
+  su_window_release(self->window);
+
+  free(self);
+}
+
+SU_INSTANCER(su_specttuner_filter_cache, unsigned int window_size)
+{
+  su_specttuner_filter_cache_t *new = NULL;
+
+  SU_ALLOCATE_FAIL(new, su_specttuner_filter_cache_t);
+
+  SU_TRY_FAIL(su_refcache_init(&new->responses, &g_filter_response_class));
+  new->responses_init = SU_TRUE;
+
+  new->window_size = window_size;
+
+  SU_TRY_FAIL(
+      new->buffer = SU_FFTW(_malloc)(window_size * sizeof(SU_FFTW(_complex))));
+
+  SU_TRY_FAIL(
+      new->window = su_window_acquire(SU_WINDOW_BLACKMANN_HARRIS, window_size));
+
+  /*
+   * These plans are executed on the response buffer of every filter
+   * (see fftw_execute_dft), which is allocated the same way.
+   */
+  SU_TRY_FAIL(
+      new->forward = su_lib_acquire_dft_plan(
           window_size,
-          channel->h,
-          channel->h,
+          1,
+          new->buffer,
+          new->buffer,
           FFTW_FORWARD,
           su_lib_fftw_strategy()));
 
-  /* Forward plan */
-  SU_TRY(
-      channel->backward = su_lib_plan_dft_1d(
+  SU_TRY_FAIL(
+      new->backward = su_lib_acquire_dft_plan(
           window_size,
-          channel->h,
-          channel->h,
+          1,
+          new->buffer,
+          new->buffer,
           FFTW_BACKWARD,
           su_lib_fftw_strategy()));
 
-  su_specttuner_update_channel_filter(self, channel);
+  return new;
 
-  ok = SU_TRUE;
-done:
+fail:
+  if (new != NULL)
+    SU_DISPOSE(su_specttuner_filter_cache, new);
 
-  return ok;
+  return NULL;
+}
+
+SU_METHOD(
+    su_specttuner_filter_cache,
+    su_specttuner_filter_t *,
+    acquire,
+    unsigned int halfw,
+    SUFLOAT k)
+{
+  su_specttuner_filter_t key;
+
+  memset(&key, 0, sizeof(su_specttuner_filter_t));
+
+  key.cache = self;
+  key.halfw = halfw;
+  key.k     = k;
+
+  return (su_specttuner_filter_t *)su_refcache_acquire(
+      &self->responses,
+      &key);
+}
+
+SU_METHOD(
+    su_specttuner_filter_cache,
+    void,
+    release,
+    su_specttuner_filter_t *filter)
+{
+  SU_TRYCATCH(su_refcache_release(&self->responses, filter), return);
 }
 
 SUPRIVATE
@@ -186,7 +303,7 @@ SU_METHOD_CONST(
   if (channel->params.precise) {
     off = (channel->center) * rbw - ef;
     off *= channel->decimation;
-    su_ncqo_set_angfreq(&channel->lo, off);
+    channel->lo.dacc = su_ncqo_ang2acc(off);
   }
 
   if (channel->params.on_freq_changed != NULL) {
@@ -228,6 +345,7 @@ SU_METHOD_CONST(
     su_specttuner_channel_t *channel,
     SUFLOAT bw)
 {
+  su_specttuner_filter_t *filter;
   SUFLOAT k;
   unsigned int width;
 
@@ -251,14 +369,443 @@ SU_METHOD_CONST(
   SU_TRYCATCH(width <= channel->size, return SU_FALSE);
   SU_TRYCATCH(width > 1, return SU_FALSE);
 
-  channel->width = width;
-  channel->halfw = channel->width >> 1;
+  SU_TRYCATCH(
+      filter = su_specttuner_filter_cache_acquire(
+          self->filter_cache,
+          width >> 1,
+          channel->k),
+      return SU_FALSE);
 
-  su_specttuner_update_channel_filter(self, channel);
+  su_specttuner_filter_cache_release(self->filter_cache, channel->filter);
+
+  channel->width  = width;
+  channel->halfw  = channel->width >> 1;
+  channel->filter = filter;
+  channel->h      = filter->h;
 
   return SU_TRUE;
 }
 
+/************************** Channel LO helpers *******************************/
+#define SU_SPECTTUNER_LO_RESYNC 64
+
+SUINLINE void
+__su_specttuner_lo_advance(su_specttuner_lo_t *lo, SUSCOUNT size)
+{
+  lo->acc += (uint32_t) size * lo->dacc;
+}
+
+/*
+ * Fills out with the next size phasors of the LO. Phasors are obtained by
+ * successive rotations, and computed exactly every SU_SPECTTUNER_LO_RESYNC
+ * samples to prevent rounding errors from building up.
+ */
+SUINLINE void
+__su_specttuner_lo_read_bulk(
+    su_specttuner_lo_t *lo,
+    SUCOMPLEX *out,
+    SUSCOUNT size)
+{
+  SUCOMPLEX step = SU_C_EXP(I * su_ncqo_acc2ang(lo->dacc));
+  SUCOMPLEX phase;
+  SUSCOUNT i, j, n;
+
+  for (i = 0; i < size; i += n) {
+    n = SU_MIN(size - i, SU_SPECTTUNER_LO_RESYNC);
+    phase = SU_C_EXP(I * su_ncqo_acc2ang(lo->acc + (uint32_t) i * lo->dacc));
+
+    for (j = 0; j < n; ++j) {
+      out[i + j] = phase;
+      phase *= step;
+    }
+  }
+
+  __su_specttuner_lo_advance(lo, size);
+}
+
+/************************** Channel glue kernels *****************************/
+/*
+ * Non-precise channels are corrected by the sign of their center bin
+ * (1 - (center & 2)). Precise channels are corrected by their LO instead,
+ * which is also applied to the samples that are not overlapped. When
+ * early windowing is enabled, IFFTs are already windowed.
+ */
+SUPRIVATE void
+__su_specttuner_glue_early(su_specttuner_channel_t *channel, SUCOMPLEX *curr)
+{
+  const SUCOMPLEX *prev = channel->tail;
+  SUFLOAT alpha = (channel->center & 2) ? -channel->gain : channel->gain;
+  SUFLOAT beta = (channel->old_center & 2) ? -channel->gain : channel->gain;
+  unsigned int i;
+
+  for (i = 0; i < channel->ovsz; ++i)
+    curr[i] = alpha * curr[i] + beta * prev[i];
+
+  for (i = channel->ovsz; i < channel->hopsz; ++i)
+    curr[i] *= alpha;
+}
+
+SUPRIVATE void
+__su_specttuner_glue_late(su_specttuner_channel_t *channel, SUCOMPLEX *curr)
+{
+  const SUCOMPLEX *prev = channel->tail;
+  const SUFLOAT *rise = channel->window;
+  const SUFLOAT *fall = channel->window + channel->hopsz;
+  SUFLOAT alpha = (channel->center & 2) ? -channel->gain : channel->gain;
+  SUFLOAT beta = (channel->old_center & 2) ? -channel->gain : channel->gain;
+  unsigned int i;
+
+  for (i = 0; i < channel->ovsz; ++i)
+    curr[i] = alpha * rise[i] * curr[i] + beta * fall[i] * prev[i];
+
+  for (i = channel->ovsz; i < channel->hopsz; ++i)
+    curr[i] *= alpha;
+}
+
+SUINLINE void
+__su_specttuner_glue_precise_flat(
+    const su_specttuner_channel_t *channel,
+    SUCOMPLEX *curr)
+{
+  const SUCOMPLEX *phase = channel->phase;
+  unsigned int i;
+
+  for (i = channel->ovsz; i < channel->hopsz; ++i)
+    curr[i] *= channel->gain * phase[i];
+}
+
+SUPRIVATE void
+__su_specttuner_glue_precise_early(
+    su_specttuner_channel_t *channel,
+    SUCOMPLEX *curr)
+{
+  const SUCOMPLEX *prev = channel->tail;
+  const SUCOMPLEX *phase = channel->phase;
+  unsigned int i;
+
+  __su_specttuner_lo_read_bulk(&channel->lo, channel->phase, channel->hopsz);
+
+  for (i = 0; i < channel->ovsz; ++i)
+    curr[i] = channel->gain * phase[i] * (curr[i] + prev[i]);
+
+  __su_specttuner_glue_precise_flat(channel, curr);
+}
+
+SUPRIVATE void
+__su_specttuner_glue_precise_late(
+    su_specttuner_channel_t *channel,
+    SUCOMPLEX *curr)
+{
+  const SUCOMPLEX *prev = channel->tail;
+  const SUCOMPLEX *phase = channel->phase;
+  const SUFLOAT *rise = channel->window;
+  const SUFLOAT *fall = channel->window + channel->hopsz;
+  unsigned int i;
+
+  __su_specttuner_lo_read_bulk(&channel->lo, channel->phase, channel->hopsz);
+
+  for (i = 0; i < channel->ovsz; ++i)
+    curr[i] =
+        channel->gain * phase[i] * (rise[i] * curr[i] + fall[i] * prev[i]);
+
+  __su_specttuner_glue_precise_flat(channel, curr);
+}
+
+/* The previous IFFT was recentered by the old LO */
+SUPRIVATE void
+__su_specttuner_glue_precise_retune_early(
+    su_specttuner_channel_t *channel,
+    SUCOMPLEX *curr)
+{
+  const SUCOMPLEX *prev = channel->tail;
+  const SUCOMPLEX *phase = channel->phase;
+  const SUCOMPLEX *phold = channel->phase + channel->hopsz;
+  unsigned int i;
+
+  __su_specttuner_lo_read_bulk(&channel->lo, channel->phase, channel->hopsz);
+  __su_specttuner_lo_read_bulk(
+      &channel->old_lo,
+      channel->phase + channel->hopsz,
+      channel->ovsz);
+
+  for (i = 0; i < channel->ovsz; ++i)
+    curr[i] = channel->gain * (phase[i] * curr[i] + phold[i] * prev[i]);
+
+  __su_specttuner_glue_precise_flat(channel, curr);
+}
+
+SUPRIVATE void
+__su_specttuner_glue_precise_retune_late(
+    su_specttuner_channel_t *channel,
+    SUCOMPLEX *curr)
+{
+  const SUCOMPLEX *prev = channel->tail;
+  const SUCOMPLEX *phase = channel->phase;
+  const SUCOMPLEX *phold = channel->phase + channel->hopsz;
+  const SUFLOAT *rise = channel->window;
+  const SUFLOAT *fall = channel->window + channel->hopsz;
+  unsigned int i;
+
+  __su_specttuner_lo_read_bulk(&channel->lo, channel->phase, channel->hopsz);
+  __su_specttuner_lo_read_bulk(
+      &channel->old_lo,
+      channel->phase + channel->hopsz,
+      channel->ovsz);
+
+  for (i = 0; i < channel->ovsz; ++i)
+    curr[i] = channel->gain
+              * (phase[i] * rise[i] * curr[i] + phold[i] * fall[i] * prev[i]);
+
+  __su_specttuner_glue_precise_flat(channel, curr);
+}
+
+/*************************** Group plan helpers ******************************/
+/*
+ * Batches are executed at arbitrary slot offsets. If the slot size is
+ * not a multiple of the SIMD alignment, FFTW must not assume it.
+ */
+SUINLINE unsigned int
+__su_specttuner_group_flags(unsigned int size, unsigned int flags)
+{
+  if ((size * sizeof(SU_FFTW(_complex))) % 64 != 0)
+    flags |= FFTW_UNALIGNED;
+
+  return flags;
+}
+
+/*
+ * Acquires a plan for a batch of transforms outside the group, on
+ * temporary buffers allocated the same way as the group buffers.
+ */
+SUPRIVATE SU_FFTW(_plan)
+__su_specttuner_plan_batch(
+    unsigned int size,
+    unsigned int howmany,
+    unsigned int flags)
+{
+  SU_FFTW(_complex) *in = NULL;
+  SU_FFTW(_complex) *out = NULL;
+  SU_FFTW(_plan) plan = NULL;
+  SUSCOUNT alloc = (SUSCOUNT) howmany * size * sizeof(SU_FFTW(_complex));
+
+  SU_TRY(in = SU_FFTW(_malloc)(alloc));
+  SU_TRY(out = SU_FFTW(_malloc)(alloc));
+
+  plan = su_lib_acquire_dft_plan(
+      size,
+      howmany,
+      in,
+      out,
+      FFTW_BACKWARD,
+      __su_specttuner_group_flags(size, flags));
+
+done:
+  if (in != NULL)
+    SU_FFTW(_free)(in);
+
+  if (out != NULL)
+    SU_FFTW(_free)(out);
+
+  return plan;
+}
+
+/************************** Lock-free command stack **************************/
+SUINLINE void
+__su_specttuner_command_push(
+    su_specttuner_command_t **stack,
+    su_specttuner_command_t *cmd)
+{
+  cmd->next = __atomic_load_n(stack, __ATOMIC_RELAXED);
+
+  while (!__atomic_compare_exchange_n(
+      stack,
+      &cmd->next,
+      cmd,
+      SU_TRUE,
+      __ATOMIC_RELEASE,
+      __ATOMIC_RELAXED));
+}
+
+/* Detaches all pending commands, and returns them in posting order */
+SUINLINE su_specttuner_command_t *
+__su_specttuner_command_pop_all(su_specttuner_command_t **stack)
+{
+  su_specttuner_command_t *top, *queue = NULL, *cmd;
+
+  if (__atomic_load_n(stack, __ATOMIC_RELAXED) == NULL)
+    return NULL;
+
+  top = __atomic_exchange_n(stack, NULL, __ATOMIC_ACQUIRE);
+
+  while ((cmd = top) != NULL) {
+    top = cmd->next;
+    cmd->next = queue;
+    queue = cmd;
+  }
+
+  return queue;
+}
+
+/*************************** Background planner ******************************/
+SUPRIVATE
+SU_METHOD(su_specttuner_planner, void, run, su_specttuner_command_t *job)
+{
+  SU_FFTW(_plan) plan;
+
+  switch (job->type) {
+    case SU_SPECTTUNER_COMMAND_PLAN:
+      /* Written under the mutex, which we do not hold here */
+      if (__atomic_load_n(&self->halt, __ATOMIC_ACQUIRE))
+        break;
+
+      plan = __su_specttuner_plan_batch(
+          job->size,
+          1 << job->index,
+          su_lib_fftw_strategy());
+
+      if (plan == NULL) {
+        SU_WARNING(
+            "Cannot plan %d transforms of size %d\n",
+            1 << job->index,
+            job->size);
+        break;
+      }
+
+      /* Reuse this job as the command that brings the plan back */
+      job->type = SU_SPECTTUNER_COMMAND_SWAP_PLAN;
+      job->plan = plan;
+      __su_specttuner_command_push(&self->owner->commands, job);
+      return;
+
+    case SU_SPECTTUNER_COMMAND_RELEASE_PLAN:
+      su_lib_release_plan(job->plan);
+      break;
+
+    default:
+      break;
+  }
+
+  free(job);
+}
+
+SUPRIVATE void *
+su_specttuner_planner_thread(void *userdata)
+{
+  su_specttuner_planner_t *self = (su_specttuner_planner_t *) userdata;
+  su_specttuner_command_t *queue, *job;
+  SUBOOL halt = SU_FALSE;
+
+  do {
+    (void) pthread_mutex_lock(&self->mutex);
+    while (!self->halt
+           && __atomic_load_n(&self->jobs, __ATOMIC_RELAXED) == NULL)
+      (void) pthread_cond_wait(&self->cond, &self->mutex);
+    halt = self->halt;
+    (void) pthread_mutex_unlock(&self->mutex);
+
+    /* On halt, pending plans are still released */
+    queue = __su_specttuner_command_pop_all(&self->jobs);
+
+    while ((job = queue) != NULL) {
+      queue = job->next;
+      su_specttuner_planner_run(self, job);
+    }
+  } while (!halt);
+
+  return NULL;
+}
+
+SU_INSTANCER(su_specttuner_planner, su_specttuner_t *owner)
+{
+  su_specttuner_planner_t *new = NULL;
+
+  SU_ALLOCATE_FAIL(new, su_specttuner_planner_t);
+
+  new->owner = owner;
+
+  SU_TRYZ_FAIL(pthread_mutex_init(&new->mutex, NULL));
+  new->mutex_init = SU_TRUE;
+
+  SU_TRYZ_FAIL(pthread_cond_init(&new->cond, NULL));
+  new->cond_init = SU_TRUE;
+
+  SU_TRYZ_FAIL(
+      pthread_create(&new->thread, NULL, su_specttuner_planner_thread, new));
+  new->thread_running = SU_TRUE;
+
+  return new;
+
+fail:
+  if (new != NULL)
+    su_specttuner_planner_destroy(new);
+
+  return NULL;
+}
+
+SU_COLLECTOR(su_specttuner_planner)
+{
+  su_specttuner_command_t *queue, *job;
+
+  if (self->thread_running) {
+    (void) pthread_mutex_lock(&self->mutex);
+    __atomic_store_n(&self->halt, SU_TRUE, __ATOMIC_RELEASE);
+    (void) pthread_cond_signal(&self->cond);
+    (void) pthread_mutex_unlock(&self->mutex);
+
+    (void) pthread_join(self->thread, NULL);
+  }
+
+  /* Nothing should be left here, but just in case */
+  queue = __su_specttuner_command_pop_all(&self->jobs);
+  while ((job = queue) != NULL) {
+    queue = job->next;
+    su_specttuner_planner_run(self, job);
+  }
+
+  if (self->cond_init)
+    (void) pthread_cond_destroy(&self->cond);
+
+  if (self->mutex_init)
+    (void) pthread_mutex_destroy(&self->mutex);
+
+  free(self);
+}
+
+/*
+ * The mutex is only held by the planner thread while it is waiting for
+ * jobs, so this never blocks for long.
+ */
+SUPRIVATE
+SU_METHOD(su_specttuner_planner, void, post, su_specttuner_command_t *job)
+{
+  __su_specttuner_command_push(&self->jobs, job);
+
+  (void) pthread_mutex_lock(&self->mutex);
+  (void) pthread_cond_signal(&self->cond);
+  (void) pthread_mutex_unlock(&self->mutex);
+}
+
+/* Releases a plan from the feeding thread */
+SUPRIVATE
+SU_METHOD(su_specttuner, void, release_plan, SU_FFTW(_plan) plan)
+{
+  su_specttuner_command_t *job = NULL;
+
+  if (plan == NULL)
+    return;
+
+  if (self->planner != NULL) {
+    if ((job = calloc(1, sizeof(su_specttuner_command_t))) != NULL) {
+      job->type = SU_SPECTTUNER_COMMAND_RELEASE_PLAN;
+      job->plan = plan;
+      su_specttuner_planner_post(self->planner, job);
+      return;
+    }
+  }
+
+  su_lib_release_plan(plan);
+}
+
 SUPRIVATE
 SU_INSTANCER(
     su_specttuner_channel,
@@ -269,7 +816,6 @@ SU_INSTANCER(
   unsigned int window_size = owner->params.window_size;
   SUFLOAT rbw = 2 * PI / window_size;
   unsigned int n = 1;
-  unsigned int i;
   unsigned int min_size;
   SUFLOAT actual_bw;
   SUFLOAT off;
@@ -331,7 +877,7 @@ SU_INSTANCER(
     min_size = SU_CEIL(new->k *window_size);
 
     /* Find the nearest power of 2 than can hold all these samples */
-    while (n < min_size)
+    while (n < min_size || n < owner->params.overlap)
       n <<= 1;
 
     new->size = n;
@@ -360,30 +906,33 @@ SU_INSTANCER(
   if (params->precise) {
     off = new->center *(2 * PI) / (SUFLOAT)window_size - effective_freq;
     off *= new->decimation;
-    su_ncqo_init(&new->lo, SU_ANG2NORM_FREQ(off));
+    new->lo.dacc = su_ncqo_ang2acc(off);
   }
 
   new->halfsz = new->size >> 1;
   new->offset = new->size >> 2;
+  new->ovsz   = new->size / owner->params.overlap;
+  new->hopsz  = new->size - new->ovsz;
 
   new->gain = 1.;
 
   SU_TRY_FAIL(new->width > 0);
 
-  /*
-   * Window function. We leverage fftw(f)_malloc aligned addresses
-   * to attempt some kind of cache efficiency here.
-   */
-  SU_TRY_FAIL(new->window = SU_FFTW(_malloc)(new->size * sizeof(SUFLOAT)));
-
   SU_TRY_FAIL(
-      new->h = SU_FFTW(_malloc)(window_size * sizeof(SU_FFTW(_complex))));
+      new->filter = su_specttuner_filter_cache_acquire(
+          owner->filter_cache,
+          new->halfw,
+          new->k));
 
-  SU_TRY_FAIL(su_specttuner_init_filter_response(owner, new));
+  new->h = new->filter->h;
 
+  /*
+   * Window function. Tables come from the window cache, which allocates
+   * them like fftw(f)_malloc does and shares them among channels.
+   */
   if (owner->params.early_windowing) {
-    for (i = 0; i < new->size; ++i)
-      new->window[i] = 1.;
+    SU_TRY_FAIL(
+        new->window = su_window_acquire(SU_WINDOW_RECTANGULAR, new->size));
   } else {
     /*
      * Squared cosine window. Seems odd, right? Well, it turns out that
@@ -400,51 +949,46 @@ SU_INSTANCER(
      * PS: We use SU_SIN instead of SU_COS because we are assuming that
      * the 0 is at new->size/2.
      */
-    for (i = 0; i < new->size; ++i) {
-      new->window[i] = SU_SIN(PI * (SUFLOAT)i / new->size);
-      new->window[i] *= new->window[i];
-    }
+    SU_TRY_FAIL(
+        new->window = su_window_acquire_overlap(new->size, new->ovsz));
   }
   
-  /* FFT initialization */
-  SU_TRY_FAIL(
-      new->ifft[SU_SPECTTUNER_STATE_EVEN] =
-          SU_FFTW(_malloc)(new->size * sizeof(SU_FFTW(_complex))));
-
+  /* Overlap buffer. FFT buffers are provided by the channel group. */
   SU_TRY_FAIL(
-      new->ifft[SU_SPECTTUNER_STATE_ODD] =
-          SU_FFTW(_malloc)(new->size * sizeof(SU_FFTW(_complex))));
+      new->tail = SU_FFTW(_malloc)(new->ovsz * sizeof(SU_FFTW(_complex))));
 
-  SU_TRY_FAIL(
-      new->fft = SU_FFTW(_malloc)(new->size * sizeof(SU_FFTW(_complex))));
+  memset(new->tail, 0, new->ovsz * sizeof(SU_FFTW(_complex)));
+  new->silent_tail = SU_TRUE;
 
-  memset(new->fft, 0, new->size * sizeof(SU_FFTW(_complex)));
+  /* Groups under background planning start with this plan */
+  if (owner->planner != NULL)
+    SU_TRY_FAIL(
+        new->seed_plan = __su_specttuner_plan_batch(new->size, 1, FFTW_ESTIMATE));
 
-  memset(
-      new->ifft[SU_SPECTTUNER_STATE_EVEN],
-      0,
-      new->size * sizeof(SU_FFTW(_complex)));
+  /* Pick glue kernels for this configuration */
+  if (params->precise) {
+    SU_TRY_FAIL(
+        new->phase = SU_FFTW(_malloc)(
+            (new->hopsz + new->ovsz) * sizeof(SU_FFTW(_complex))));
 
-  memset(
-      new->ifft[SU_SPECTTUNER_STATE_ODD],
-      0,
-      new->size * sizeof(SU_FFTW(_complex)));
+    if (owner->params.early_windowing) {
+      new->glue = __su_specttuner_glue_precise_early;
+      new->glue_retune = __su_specttuner_glue_precise_retune_early;
+    } else {
+      new->glue = __su_specttuner_glue_precise_late;
+      new->glue_retune = __su_specttuner_glue_precise_retune_late;
+    }
+  } else {
+    /* Sign changes are handled by the kernel itself */
+    if (owner->params.early_windowing)
+      new->glue = __su_specttuner_glue_early;
+    else
+      new->glue = __su_specttuner_glue_late;
 
-  SU_TRY_FAIL(
-      new->plan[SU_SPECTTUNER_STATE_EVEN] = su_lib_plan_dft_1d(
-          new->size,
-          new->fft,
-          new->ifft[SU_SPECTTUNER_STATE_EVEN],
-          FFTW_BACKWARD,
-          su_lib_fftw_strategy()));
+    new->glue_retune = new->glue;
+  }
 
-  SU_TRY_FAIL(
-      new->plan[SU_SPECTTUNER_STATE_ODD] = su_lib_plan_dft_1d(
-          new->size,
-          new->fft,
-          new->ifft[SU_SPECTTUNER_STATE_ODD],
-          FFTW_BACKWARD,
-          su_lib_fftw_strategy()));
+  new->old_center = new->center;
 
   return new;
 
@@ -455,6 +999,377 @@ fail:
   return NULL;
 }
 
+/**************************** Channel groups ********************************/
+SUPRIVATE
+SU_COLLECTOR(su_specttuner_group)
+{
+  unsigned int i;
+
+  if (self->plan_list != NULL) {
+    for (i = 0; i < self->plan_count; ++i)
+      if (self->plan_list[i] != NULL)
+        su_lib_release_plan(self->plan_list[i]);
+
+    free(self->plan_list);
+  }
+
+  if (self->member_list != NULL)
+    free(self->member_list);
+
+  if (self->fft != NULL)
+    SU_FFTW(_free)(self->fft);
+
+  if (self->ifft != NULL)
+    SU_FFTW(_free)(self->ifft);
+
+  free(self);
+}
+
+SUPRIVATE
+SU_INSTANCER(su_specttuner_group, unsigned int size)
+{
+  su_specttuner_group_t *new = NULL;
+
+  SU_ALLOCATE_FAIL(new, su_specttuner_group_t);
+
+  new->size = size;
+
+  return new;
+
+fail:
+  if (new != NULL)
+    SU_DISPOSE(su_specttuner_group, new);
+
+  return NULL;
+}
+
+/* Update the buffer pointers of every member according to its slot */
+SUPRIVATE
+SU_METHOD(su_specttuner_group, void, refresh_members)
+{
+  unsigned int i;
+  SUSCOUNT offset;
+
+  for (i = 0; i < self->count; ++i) {
+    offset = (SUSCOUNT) i * self->size;
+    self->member_list[i]->slot = i;
+    self->member_list[i]->fft  = self->fft + offset;
+    self->member_list[i]->ifft = self->ifft + offset;
+  }
+}
+
+SUPRIVATE
+SU_METHOD(su_specttuner_group, SUBOOL, reserve, unsigned int count)
+{
+  unsigned int capacity = self->capacity > 0 ? self->capacity : 1;
+  unsigned int plan_count = 0;
+  unsigned int flags = su_lib_fftw_strategy();
+  su_specttuner_channel_t **member_list = NULL;
+  SU_FFTW(_complex) *fft = NULL;
+  SU_FFTW(_complex) *ifft = NULL;
+  SU_FFTW(_plan) *plan_list = NULL;
+  su_specttuner_channel_t **tmp_members;
+  SU_FFTW(_complex) *tmp_buf;
+  SU_FFTW(_plan) *tmp_plans;
+  unsigned int tmp_count;
+  SUSCOUNT alloc;
+  unsigned int i;
+  SUBOOL ok = SU_FALSE;
+
+  if (count <= self->capacity)
+    return SU_TRUE;
+
+  while (capacity < count)
+    capacity <<= 1;
+
+  while ((1u << plan_count) <= capacity)
+    ++plan_count;
+
+  alloc = (SUSCOUNT) capacity * self->size * sizeof(SU_FFTW(_complex));
+
+  SU_ALLOCATE_MANY(member_list, capacity, su_specttuner_channel_t *);
+  SU_ALLOCATE_MANY(plan_list, plan_count, SU_FFTW(_plan));
+  SU_TRY(fft = SU_FFTW(_malloc)(alloc));
+  SU_TRY(ifft = SU_FFTW(_malloc)(alloc));
+
+  memset(fft, 0, alloc);
+  memset(ifft, 0, alloc);
+
+  if (self->deferred) {
+    /* Keep what we have. The planner will provide the rest. */
+    for (i = 0; i < self->plan_count; ++i) {
+      plan_list[i] = self->plan_list[i];
+      self->plan_list[i] = NULL;
+    }
+  } else {
+    flags = __su_specttuner_group_flags(self->size, flags);
+
+    for (i = 0; i < plan_count; ++i)
+      SU_TRY(
+          plan_list[i] = su_lib_acquire_dft_plan(
+              self->size,
+              1 << i,
+              fft,
+              ifft,
+              FFTW_BACKWARD,
+              flags));
+  }
+
+  if (self->count > 0)
+    memcpy(
+        member_list,
+        self->member_list,
+        self->count * sizeof(su_specttuner_channel_t *));
+
+  /* Swap buffers. The old ones are released below. */
+  _SWAP(self->member_list, member_list, tmp_members);
+  _SWAP(self->plan_list, plan_list, tmp_plans);
+  _SWAP(self->plan_count, plan_count, tmp_count);
+  _SWAP(self->fft, fft, tmp_buf);
+  _SWAP(self->ifft, ifft, tmp_buf);
+
+  self->capacity = capacity;
+
+  su_specttuner_group_refresh_members(self);
+
+  ok = SU_TRUE;
+
+done:
+  if (plan_list != NULL) {
+    for (i = 0; i < plan_count; ++i)
+      if (plan_list[i] != NULL)
+        su_lib_release_plan(plan_list[i]);
+    free(plan_list);
+  }
+
+  if (member_list != NULL)
+    free(member_list);
+
+  if (fft != NULL)
+    SU_FFTW(_free)(fft);
+
+  if (ifft != NULL)
+    SU_FFTW(_free)(ifft);
+
+  return ok;
+}
+
+SUPRIVATE
+SU_METHOD(su_specttuner_group, SUBOOL, add, su_specttuner_channel_t *channel)
+{
+  SU_TRYCATCH(
+      su_specttuner_group_reserve(self, self->count + 1),
+      return SU_FALSE);
+
+  self->member_list[self->count++] = channel;
+  channel->group = self;
+
+  su_specttuner_group_refresh_members(self);
+
+  return SU_TRUE;
+}
+
+SUPRIVATE
+SU_METHOD(su_specttuner_group, void, remove, su_specttuner_channel_t *channel)
+{
+  /* Keep slots compact: the last member takes the place of the removed one */
+  self->member_list[channel->slot] = self->member_list[--self->count];
+  self->member_list[self->count] = NULL;
+
+  /* Spectra are rebuilt bin by bin. Do not inherit the removed one. */
+  memset(
+      self->fft + (SUSCOUNT) channel->slot * self->size,
+      0,
+      self->size * sizeof(SU_FFTW(_complex)));
+
+  channel->group = NULL;
+  channel->fft   = NULL;
+  channel->ifft  = NULL;
+
+  su_specttuner_group_refresh_members(self);
+}
+
+/*
+ * Moves the time-domain members to the first slots. Frequency-domain
+ * members never need an inverse FFT, and since they deliver their spectrum
+ * straight from their slot, they must not be moved once the window has
+ * been prepared. This is why the domain of every member is latched here,
+ * before preparing the window.
+ */
+SUPRIVATE
+SU_METHOD(su_specttuner_group, void, sort_domains)
+{
+  unsigned int i = 0;
+  unsigned int j = self->count;
+  su_specttuner_channel_t *tmp;
+  SUBOOL moved = SU_FALSE;
+
+  while (i < j) {
+    if (self->member_list[i]->params.domain
+        == SU_SPECTTUNER_CHANNEL_TIME_DOMAIN) {
+      self->member_list[i++]->freq_domain = SU_FALSE;
+    } else if (
+        self->member_list[j - 1]->params.domain
+        != SU_SPECTTUNER_CHANNEL_TIME_DOMAIN) {
+      self->member_list[--j]->freq_domain = SU_TRUE;
+    } else {
+      /* Rare (domain changes only). Both spectra are rebuilt from scratch. */
+      --j;
+      _SWAP(self->member_list[i], self->member_list[j], tmp);
+      memset(
+          self->fft + (SUSCOUNT) i * self->size,
+          0,
+          self->size * sizeof(SU_FFTW(_complex)));
+      memset(
+          self->fft + (SUSCOUNT) j * self->size,
+          0,
+          self->size * sizeof(SU_FFTW(_complex)));
+      self->member_list[i++]->freq_domain = SU_FALSE;
+      self->member_list[j]->freq_domain   = SU_TRUE;
+      moved = SU_TRUE;
+    }
+  }
+
+  self->time_count = i;
+
+  if (moved)
+    su_specttuner_group_refresh_members(self);
+}
+
+/*
+ * Moves the time-domain members that are not squelched in this window to
+ * the first slots. Only the spectra of these need to be transformed.
+ */
+SUPRIVATE
+SU_METHOD(su_specttuner_group, void, sort_active)
+{
+  unsigned int i = 0;
+  unsigned int j = self->time_count;
+  su_specttuner_channel_t *tmp;
+  SUBOOL moved = SU_FALSE;
+
+  while (i < j) {
+    if (!self->member_list[i]->squelched) {
+      ++i;
+    } else if (self->member_list[j - 1]->squelched) {
+      --j;
+    } else {
+      /* The spectrum of the squelched channel is not needed */
+      --j;
+      memcpy(
+          self->fft + (SUSCOUNT) i * self->size,
+          self->fft + (SUSCOUNT) j * self->size,
+          self->size * sizeof(SU_FFTW(_complex)));
+      _SWAP(self->member_list[i], self->member_list[j], tmp);
+      ++i;
+      moved = SU_TRUE;
+    }
+  }
+
+  self->active = i;
+
+  if (moved)
+    su_specttuner_group_refresh_members(self);
+}
+
+/* One batch per bit set in the number of active slots */
+SUINLINE unsigned int
+__su_specttuner_group_get_batch_count(const su_specttuner_group_t *self)
+{
+  unsigned int count = self->active;
+  unsigned int batches = 0;
+
+  while (count != 0) {
+    count &= count - 1;
+    ++batches;
+  }
+
+  return batches;
+}
+
+/*
+ * Runs the inverse transforms of the batch-th batch of the binary
+ * decomposition of the active slots.
+ */
+SUINLINE void
+__su_specttuner_group_execute(const su_specttuner_group_t *self, unsigned int batch)
+{
+  unsigned int i = self->plan_count;
+  unsigned int j;
+  SUSCOUNT offset = 0;
+
+  while (i-- > 0) {
+    if (self->active & (1u << i)) {
+      if (batch-- == 0) {
+        if (self->plan_list[i] != NULL) {
+          SU_FFTW(_execute_dft)(
+              self->plan_list[i],
+              self->fft + offset,
+              self->ifft + offset);
+        } else {
+          /* Batch plan still being computed by the planner */
+          for (j = 0; j < (1u << i); ++j, offset += self->size)
+            SU_FFTW(_execute_dft)(
+                self->plan_list[0],
+                self->fft + offset,
+                self->ifft + offset);
+        }
+        return;
+      }
+
+      offset += (SUSCOUNT) self->size << i;
+    }
+  }
+}
+
+SUPRIVATE
+SU_METHOD(
+    su_specttuner,
+    su_specttuner_group_t *,
+    assert_group,
+    unsigned int size)
+{
+  su_specttuner_group_t *group = NULL;
+  unsigned int i;
+
+  for (i = 0; i < self->group_count; ++i)
+    if (self->group_list[i] != NULL && self->group_list[i]->size == size)
+      return self->group_list[i];
+
+  SU_MAKE_FAIL(group, su_specttuner_group, size);
+  SU_TRYC_FAIL(PTR_LIST_APPEND_CHECK(self->group, group));
+
+  group->deferred = self->planner != NULL;
+
+  return group;
+
+fail:
+  if (group != NULL)
+    su_specttuner_group_destroy(group);
+
+  return NULL;
+}
+
+SUPRIVATE
+SU_METHOD(su_specttuner, void, release_group, su_specttuner_group_t *group)
+{
+  unsigned int i;
+
+  if (group->count > 0)
+    return;
+
+  for (i = 0; i < self->group_count; ++i)
+    if (self->group_list[i] == group)
+      self->group_list[i] = NULL;
+
+  for (i = 0; i < group->plan_count; ++i) {
+    su_specttuner_release_plan(self, group->plan_list[i]);
+    group->plan_list[i] = NULL;
+  }
+
+  su_specttuner_group_destroy(group);
+}
+
 SU_METHOD(
     su_specttuner,
     su_specttuner_plan_t *,
@@ -465,6 +1380,11 @@ SU_METHOD(
   SUBOOL ok = SU_FALSE;
   SUSCOUNT offset;
 
+  if (self->params.real_input) {
+    SU_ERROR("Custom plans are not supported in real input mode\n");
+    return NULL;
+  }
+
   offset = in == self->fft ? 0 : self->params.window_size / 2;
 
   SU_MAKE(new, su_specttuner_plan, in, self->fft, self->params.window_size, offset);
@@ -484,16 +1404,40 @@ done:
   return new;
 }
 
+SUPRIVATE SU_METHOD(su_specttuner, void, run_commands);
+
 SU_COLLECTOR(su_specttuner)
 {
   unsigned int i;
 
-  for (i = 0; i < self->channel_count; ++i)
-    if (self->channel_list[i] != NULL)
-      (void)su_specttuner_close_channel(self, self->channel_list[i]);
+  /* Stop workers before releasing anything they may be touching */
+  if (self->pool != NULL)
+    su_specttuner_pool_destroy(self->pool);
+
+  /* Attach or destroy channels with pending commands */
+  su_specttuner_run_commands(self);
+
+  while (self->channel_count > 0)
+    (void)su_specttuner_close_channel(self, self->channel_list[0]);
+
+  PTR_SLOTMAP_FINALIZE(self->channel);
+
+  /* Plans computed in the meantime are released right here */
+  if (self->planner != NULL) {
+    su_specttuner_planner_destroy(self->planner);
+    self->planner = NULL;
+    su_specttuner_run_commands(self);
+  }
+
+  for (i = 0; i < self->group_count; ++i)
+    if (self->group_list[i] != NULL)
+      su_specttuner_group_destroy(self->group_list[i]);
+
+  if (self->group_list != NULL)
+    free(self->group_list);
 
-  if (self->channel_list != NULL)
-    free(self->channel_list);
+  if (self->filter_cache != NULL)
+    su_specttuner_filter_cache_destroy(self->filter_cache);
 
   for (i = 0; i < self->plan_count; ++i)
     if (self->plan_list[i] != NULL)
@@ -505,12 +1449,20 @@ SU_COLLECTOR(su_specttuner)
   if (self->fft != NULL)
     SU_FFTW(_free)(self->fft);
 
-  if (self->wfunc != NULL)
-    free(self->wfunc);
+  su_window_release(self->wfunc);
 
   if (self->buffer != NULL && self->params.buffer != self->buffer)
     SU_FFTW(_free)(self->buffer);
 
+  if (self->real_plan[SU_SPECTTUNER_STATE_EVEN] != NULL)
+    su_lib_release_plan(self->real_plan[SU_SPECTTUNER_STATE_EVEN]);
+
+  if (self->real_plan[SU_SPECTTUNER_STATE_ODD] != NULL)
+    su_lib_release_plan(self->real_plan[SU_SPECTTUNER_STATE_ODD]);
+
+  if (self->real_buffer != NULL)
+    SU_FFTW(_free)(self->real_buffer);
+
   free(self);
 }
 
@@ -525,19 +1477,24 @@ SU_INSTANCER(
 
   SU_ALLOCATE_FAIL(new, su_specttuner_plan_t);
 
+  new->in[SU_SPECTTUNER_STATE_EVEN] = in;
+  new->in[SU_SPECTTUNER_STATE_ODD]  = in + offset; /* Odd plan stars at window_size / 2 */
+  new->out = out;
+
   SU_TRY_FAIL(
-      new->plans[SU_SPECTTUNER_STATE_EVEN] = su_lib_plan_dft_1d(
+      new->plans[SU_SPECTTUNER_STATE_EVEN] = su_lib_acquire_dft_plan(
           size,
-          in,
+          1,
+          new->in[SU_SPECTTUNER_STATE_EVEN],
           out,
           FFTW_FORWARD,
           su_lib_fftw_strategy()));
 
-  /* Odd plan stars at window_size / 2 */
   SU_TRY_FAIL(
-      new->plans[SU_SPECTTUNER_STATE_ODD] = su_lib_plan_dft_1d(
+      new->plans[SU_SPECTTUNER_STATE_ODD] = su_lib_acquire_dft_plan(
           size,
-          in + offset,
+          1,
+          new->in[SU_SPECTTUNER_STATE_ODD],
           out,
           FFTW_FORWARD,
           su_lib_fftw_strategy()));
@@ -554,41 +1511,213 @@ fail:
 SU_COLLECTOR(su_specttuner_plan)
 {
   if (self->plans[SU_SPECTTUNER_STATE_EVEN] != NULL)
-    SU_FFTW(_destroy_plan)(self->plans[SU_SPECTTUNER_STATE_EVEN]);
+    su_lib_release_plan(self->plans[SU_SPECTTUNER_STATE_EVEN]);
 
   if (self->plans[SU_SPECTTUNER_STATE_ODD] != NULL)
-    SU_FFTW(_destroy_plan)(self->plans[SU_SPECTTUNER_STATE_ODD]);
+    su_lib_release_plan(self->plans[SU_SPECTTUNER_STATE_ODD]);
+
+  free(self);
+}
+
+/************************** Channel worker pool *****************************/
+SUPRIVATE void *
+su_specttuner_worker_thread(void *userdata)
+{
+  su_specttuner_worker_t *worker = (su_specttuner_worker_t *) userdata;
+  su_specttuner_pool_t *pool = worker->pool;
+  su_specttuner_pool_job_t job;
+  unsigned int epoch = 0;
+  SUBOOL ok;
+
+  (void) pthread_mutex_lock(&pool->mutex);
+
+  for (;;) {
+    while (!pool->halt && pool->epoch == epoch)
+      (void) pthread_cond_wait(&pool->job_cond, &pool->mutex);
+
+    if (pool->halt)
+      break;
+
+    epoch = pool->epoch;
+    job   = pool->job;
+
+    (void) pthread_mutex_unlock(&pool->mutex);
+
+    ok = (job) (pool->owner, worker->index, pool->worker_count);
+
+    (void) pthread_mutex_lock(&pool->mutex);
+
+    if (!ok)
+      pool->ok = SU_FALSE;
+
+    if (--pool->pending == 0)
+      (void) pthread_cond_signal(&pool->done_cond);
+  }
+
+  (void) pthread_mutex_unlock(&pool->mutex);
+
+  return NULL;
+}
+
+SU_INSTANCER(su_specttuner_pool, su_specttuner_t *owner, unsigned int count)
+{
+  su_specttuner_pool_t *new = NULL;
+  su_specttuner_worker_t *worker;
+  unsigned int i;
+
+  SU_TRYCATCH(count > 1, goto fail);
+
+  SU_ALLOCATE_FAIL(new, su_specttuner_pool_t);
+
+  new->owner = owner;
+  new->worker_count = count;
+
+  SU_TRYZ_FAIL(pthread_mutex_init(&new->mutex, NULL));
+  new->mutex_init = SU_TRUE;
+
+  SU_TRYZ_FAIL(pthread_cond_init(&new->job_cond, NULL));
+  new->job_cond_init = SU_TRUE;
+
+  SU_TRYZ_FAIL(pthread_cond_init(&new->done_cond, NULL));
+  new->done_cond_init = SU_TRUE;
+
+  /* Slice 0 is always processed by the calling thread */
+  SU_ALLOCATE_MANY_FAIL(new->worker_list, count - 1, su_specttuner_worker_t);
+
+  for (i = 0; i < count - 1; ++i) {
+    worker = new->worker_list + i;
+    worker->pool  = new;
+    worker->index = i + 1;
+
+    SU_TRYZ_FAIL(
+        pthread_create(
+            &worker->thread,
+            NULL,
+            su_specttuner_worker_thread,
+            worker));
+    worker->thread_running = SU_TRUE;
+  }
+
+  return new;
+
+fail:
+  if (new != NULL)
+    su_specttuner_pool_destroy(new);
+
+  return NULL;
+}
+
+SU_COLLECTOR(su_specttuner_pool)
+{
+  unsigned int i;
+
+  if (self->worker_list != NULL) {
+    if (self->mutex_init) {
+      (void) pthread_mutex_lock(&self->mutex);
+      self->halt = SU_TRUE;
+      (void) pthread_cond_broadcast(&self->job_cond);
+      (void) pthread_mutex_unlock(&self->mutex);
+    }
+
+    for (i = 0; i < self->worker_count - 1; ++i)
+      if (self->worker_list[i].thread_running)
+        (void) pthread_join(self->worker_list[i].thread, NULL);
+
+    free(self->worker_list);
+  }
+
+  if (self->done_cond_init)
+    (void) pthread_cond_destroy(&self->done_cond);
+
+  if (self->job_cond_init)
+    (void) pthread_cond_destroy(&self->job_cond);
+
+  if (self->mutex_init)
+    (void) pthread_mutex_destroy(&self->mutex);
+
+  free(self);
+}
+
+SU_METHOD(su_specttuner_pool, SUBOOL, run, su_specttuner_pool_job_t job)
+{
+  SUBOOL ok;
+
+  (void) pthread_mutex_lock(&self->mutex);
+  self->job     = job;
+  self->ok      = SU_TRUE;
+  self->pending = self->worker_count - 1;
+  ++self->epoch;
+  (void) pthread_cond_broadcast(&self->job_cond);
+  (void) pthread_mutex_unlock(&self->mutex);
+
+  /* Meanwhile, take care of our own slice */
+  ok = (job) (self->owner, 0, self->worker_count);
+
+  /* Barrier: wait for the rest of the workers */
+  (void) pthread_mutex_lock(&self->mutex);
+  while (self->pending > 0)
+    (void) pthread_cond_wait(&self->done_cond, &self->mutex);
+  ok = self->ok && ok;
+  (void) pthread_mutex_unlock(&self->mutex);
+
+  return ok;
 }
 
 SU_INSTANCER(su_specttuner, const struct sigutils_specttuner_params *params)
 {
   su_specttuner_t *new = NULL;
   unsigned int full_size;
-  unsigned int i;
 
   SU_TRYCATCH((params->window_size & 1) == 0, goto fail);
 
+  if (params->overlap < 2 || (params->overlap & (params->overlap - 1)) != 0) {
+    SU_ERROR("Window overlap must be 1/2, 1/4, 1/8...\n");
+    goto fail;
+  }
+
+  SU_TRYCATCH(params->window_size % params->overlap == 0, goto fail);
+
   SU_ALLOCATE_FAIL(new, su_specttuner_t);
 
-  new->params    = *params;
-  new->half_size = params->window_size >> 1;
-  full_size      = 3 * new->half_size;
+  new->params       = *params;
+  new->half_size    = params->window_size >> 1;
+  new->overlap_size = params->window_size / params->overlap;
+  new->hop_size     = params->window_size - new->overlap_size;
+  new->linear       = params->overlap > 2;
+
+  full_size         = 3 * new->half_size;
+
+  /* So that the first window starts at 0 */
+  new->hop_phase    = new->overlap_size;
+
+  if (params->real_input && params->buffer != NULL) {
+    SU_ERROR("Custom buffers are not supported in real input mode\n");
+    goto fail;
+  }
+
+  if (new->linear && params->buffer != NULL) {
+    SU_ERROR("Custom buffers require 50%% window overlap\n");
+    goto fail;
+  }
 
   /* If we use this with custom buffers, we never do early windowing */
   if (new->params.buffer == NULL)
     new->params.early_windowing = SU_FALSE;
   
   /* Early windowing enabled */
-  if (new->params.early_windowing) {
-    SU_TRY_FAIL(new->wfunc = malloc(params->window_size * sizeof(SUFLOAT)));
-
-    for (i = 0; i < params->window_size; ++i) {
-      new->wfunc[i]  = SU_SIN(PI * (SUFLOAT) i / params->window_size);
-      new->wfunc[i] *= new->wfunc[i];
-    }
-  }
+  if (new->params.early_windowing)
+    SU_TRY_FAIL(
+        new->wfunc = su_window_acquire_overlap(
+            params->window_size,
+            new->half_size));
   
-  if (new->params.buffer == NULL) {
+  if (new->params.real_input) {
+    /* Real buffer: 3/2 the FFT size */
+    SU_TRY_FAIL(
+        new->real_buffer =
+            SU_FFTW(_malloc(full_size * sizeof(SUFLOAT))));
+    memset(new->real_buffer, 0, full_size * sizeof(SUFLOAT));
+  } else if (new->params.buffer == NULL) {
     /* Custom buffer: 3/2 the FFT size */
     SU_TRY_FAIL(
         new->buffer =
@@ -598,6 +1727,8 @@ SU_INSTANCER(su_specttuner, const struct sigutils_specttuner_params *params)
     new->buffer = new->params.buffer;
   }
 
+  SU_MAKE_FAIL(new->filter_cache, su_specttuner_filter_cache, params->window_size);
+
   /* FFT is the size provided by params */
   SU_TRY_FAIL(
       new->fft =
@@ -605,7 +1736,24 @@ SU_INSTANCER(su_specttuner, const struct sigutils_specttuner_params *params)
 
   memset(new->fft, 0, params->window_size * sizeof(SU_FFTW(_complex)));
 
-  if (new->params.early_windowing) {
+  if (new->params.real_input) {
+    /* Only window_size / 2 + 1 bins are computed */
+    SU_TRY_FAIL(
+        new->real_plan[SU_SPECTTUNER_STATE_EVEN] =
+            su_lib_acquire_dft_r2c_plan(
+                params->window_size,
+                new->real_buffer,
+                new->fft,
+                su_lib_fftw_strategy()));
+
+    SU_TRY_FAIL(
+        new->real_plan[SU_SPECTTUNER_STATE_ODD] =
+            su_lib_acquire_dft_r2c_plan(
+                params->window_size,
+                new->real_buffer + new->half_size,
+                new->fft,
+                su_lib_fftw_strategy()));
+  } else if (new->params.early_windowing) {
     SU_TRY_FAIL(
       new->default_plan = su_specttuner_make_plan(new, new->fft));
   } else {
@@ -613,7 +1761,14 @@ SU_INSTANCER(su_specttuner, const struct sigutils_specttuner_params *params)
       new->default_plan = su_specttuner_make_plan(new, new->buffer));
   }
 
-  return new;
+  if (params->num_threads > 1)
+    SU_MAKE_FAIL(new->pool, su_specttuner_pool, new, params->num_threads);
+
+  /* Nothing to measure otherwise */
+  if (params->background_planning && su_lib_fftw_strategy() != FFTW_ESTIMATE)
+    SU_MAKE_FAIL(new->planner, su_specttuner_planner, new);
+
+  return new;
 
 fail:
   if (new != NULL)
@@ -624,6 +1779,15 @@ fail:
 
 SU_METHOD(su_specttuner, void, run_fft, su_specttuner_plan_t *plan)
 {
+  /* Real input mode: always late windowing */
+  if (self->params.real_input) {
+    SU_FFTW(_execute_dft_r2c)(
+        self->real_plan[self->state],
+        self->real_buffer + self->state * self->half_size,
+        self->fft);
+    return;
+  }
+
   /* Early windowing, copy windowed input */
   if (self->params.early_windowing) {
     if (self->state == SU_SPECTTUNER_STATE_EVEN) {
@@ -657,69 +1821,166 @@ SU_METHOD(su_specttuner, void, run_fft, su_specttuner_plan_t *plan)
   su_specttuner_plan_execute(plan, self->state);
 }
 
-SUINLINE SUSCOUNT
-__su_specttuner_feed_bulk(
+SU_METHOD(su_specttuner, void, complete_window, su_specttuner_plan_t *plan)
+{
+  self->hop_phase = (self->hop_phase + self->hop_size) % self->params.window_size;
+
+  su_specttuner_run_fft(self, plan);
+
+  if (self->linear) {
+    /* Keep the overlapping part for the next window */
+    if (self->params.real_input)
+      memmove(
+          self->real_buffer,
+          self->real_buffer + self->hop_size,
+          self->overlap_size * sizeof(SUFLOAT));
+    else
+      memmove(
+          self->buffer,
+          self->buffer + self->hop_size,
+          self->overlap_size * sizeof(SUCOMPLEX));
+  } else {
+    /* Toggle state */
+    self->state = !self->state;
+  }
+
+  self->p = self->overlap_size;
+  self->ready = SU_TRUE;
+}
+
+/*
+ * Returns the position of the buffer pointed by base (either buffer or
+ * real_buffer, with elements of elsize bytes) in which the next sample
+ * must be stored, along with the number of samples that fit there before
+ * the window is complete.
+ */
+SUINLINE void *
+__su_specttuner_get_span(
+    const su_specttuner_t *self,
+    void *base,
+    size_t elsize,
+    SUSCOUNT *avail)
+{
+  SUSCOUNT p = self->p;
+
+  /* In the ODD state, we populate the second and last thirds */
+  if (self->state == SU_SPECTTUNER_STATE_ODD)
+    p += self->half_size;
+
+  *avail = self->params.window_size - self->p;
+
+  return (uint8_t *) base + p * elsize;
+}
+
+/*
+ * Accounts for size samples stored in the span returned by
+ * __su_specttuner_get_span and triggers the FFT if the window is complete.
+ */
+SUINLINE void
+__su_specttuner_commit(
     su_specttuner_t *self,
-    const SUCOMPLEX *__restrict buf,
+    void *base,
+    size_t elsize,
     SUSCOUNT size)
 {
+  uint8_t *buffer = (uint8_t *) base;
   SUSDIFF halfsz;
   SUSDIFF p;
-  
-  if (size + self->p > self->params.window_size)
-    size = self->params.window_size - self->p;
 
-  switch (self->state) {
-    case SU_SPECTTUNER_STATE_EVEN:
-      /* Just copy at the beginning */
-      memcpy(self->buffer + self->p, buf, size * sizeof(SUCOMPLEX));
-      break;
+  /* 
+   * Did this write populate the last third? In that case, the
+   * contents of the last third must be mirrored to the
+   * first third.
+   */
+  if (self->state == SU_SPECTTUNER_STATE_ODD
+      && self->p + size > self->half_size) {
+    halfsz = self->p + size - self->half_size;
+    p = self->p > self->half_size ? self->p : self->half_size;
+
+    /* Don't take into account data already written */
+    halfsz -= p - self->half_size;
 
-    case SU_SPECTTUNER_STATE_ODD:
-      /* Copy to the second third */
+    /* Copy to the first third */
+    if (halfsz > 0)
       memcpy(
-          self->buffer + self->p + self->half_size,
-          buf,
-          size * sizeof(SUCOMPLEX));
-
-      /* 
-       * Did this copy populate the last third? In that case, the
-       * contents of the last third must be mirrored to the
-       * first third.
-       */
-      if (self->p + size > self->half_size) {
-        halfsz = self->p + size - self->half_size;
-        p = self->p > self->half_size ? self->p : self->half_size;
-
-        /* Don't take into account data already written */
-        halfsz -= p - self->half_size;
-
-        /* Copy to the first third */
-        if (halfsz > 0)
-          memcpy(
-              self->buffer + p - self->half_size,
-              self->buffer + p + self->half_size,
-              halfsz * sizeof(SUCOMPLEX));
-      }
+          buffer + (p - self->half_size) * elsize,
+          buffer + (p + self->half_size) * elsize,
+          halfsz * elsize);
   }
 
   self->p += size;
 
-  if (self->p == self->params.window_size) {
-    self->p = self->half_size;
+  if (self->p == self->params.window_size)
+    su_specttuner_complete_window(self, self->default_plan);
+}
 
-    su_specttuner_run_fft(self, self->default_plan);
+/*
+ * Stores size samples of elsize bytes in the current half of the buffer
+ * pointed by base (either buffer or real_buffer) and triggers the FFT
+ * if the window is complete.
+ */
+SUINLINE SUSCOUNT
+__su_specttuner_feed_bulk(
+    su_specttuner_t *self,
+    void *base,
+    size_t elsize,
+    const void *__restrict buf,
+    SUSCOUNT size)
+{
+  SUSCOUNT avail;
+  void *span = __su_specttuner_get_span(self, base, elsize, &avail);
 
-    /* Toggle state */
-    self->state = !self->state;
-    self->ready = SU_TRUE;
-  }
+  if (size > avail)
+    size = avail;
+
+  memcpy(span, buf, size * elsize);
+
+  __su_specttuner_commit(self, base, elsize, size);
 
   return size;
 }
 
+/*
+ * Copies len bins of the window spectrum, starting from bin start (with
+ * start + len <= window_size). In real input mode only bins up to
+ * window_size / 2 are computed, and the rest are obtained from the
+ * Hermitian symmetry of the spectrum: X[N - k] = conj(X[k])
+ */
+SUINLINE void
+__su_specttuner_copy_bins(
+    const su_specttuner_t *self,
+    SUCOMPLEX *dest,
+    unsigned int start,
+    unsigned int len)
+{
+  unsigned int window_size = self->params.window_size;
+  unsigned int direct = 0;
+  unsigned int i;
+
+  if (!self->params.real_input) {
+    memcpy(dest, self->fft + start, len * sizeof(SUCOMPLEX));
+    return;
+  }
+
+  if (start <= self->half_size)
+    direct = SU_MIN(len, self->half_size + 1 - start);
+
+  memcpy(dest, self->fft + start, direct * sizeof(SUCOMPLEX));
+
+  for (i = direct; i < len; ++i)
+    dest[i] = SU_C_CONJ(self->fft[window_size - start - i]);
+}
+
+/*
+ * Feeding a channel is performed in three stages: first, the channel
+ * spectrum is extracted and filtered (__su_specttuner_prepare_channel),
+ * next, the inverse FFTs of all channels of the same size are computed in
+ * a single batch (__su_specttuner_group_execute) and finally the windows
+ * are glued together and delivered to the user
+ * (__su_specttuner_finish_channel).
+ */
 SUINLINE SUBOOL
-__su_specttuner_feed_channel(
+__su_specttuner_prepare_channel(
     const su_specttuner_t *self,
     su_specttuner_channel_t *channel)
 {
@@ -727,11 +1988,9 @@ __su_specttuner_feed_channel(
   int len;
   int window_size = self->params.window_size;
   unsigned int i;
-  SUCOMPLEX phase, phold;
-  SUFLOAT alpha, beta;
-  SUBOOL changing_freqs = SU_FALSE;
-  int a_sign, b_sign;
-  SUCOMPLEX *prev, *curr;
+  SUSCOUNT rot;
+  SUCOMPLEX k;
+  SUCOMPLEX *curr;
 
   /*
    * This is how the phase continuity trick works: as soon as a new
@@ -742,20 +2001,21 @@ __su_specttuner_feed_channel(
    * ensured, as all bins refer to frequencies multiple of 2pi.
    */
 
-  b_sign = 1 - (channel->center & 2);
+  channel->old_center = channel->center;
+  channel->changing_freqs = SU_FALSE;
 
-  if (self->state && channel->pending_freq) {
+  if ((self->state || self->linear) && channel->pending_freq) {
     channel->pending_freq = SU_FALSE;
 
-    su_ncqo_copy(&channel->old_lo, &channel->lo);
+    channel->old_lo = channel->lo;
 
     su_specttuner_refresh_channel_center(self, channel);
 
-    changing_freqs = SU_TRUE;
+    channel->changing_freqs = SU_TRUE;
   }
 
   p = channel->center;
-  a_sign = 1 - (channel->center & 2);
+  channel->squelched = SU_FALSE;
 
   /***************************** Upper sideband ******************************/
   len = channel->halfw;
@@ -763,14 +2023,15 @@ __su_specttuner_feed_channel(
     len = window_size - p;
 
   /* Copy to the end */
-  memcpy(channel->fft, self->fft + p, len * sizeof(SUCOMPLEX));
+  __su_specttuner_copy_bins(self, channel->fft, p, len);
 
   /* Copy remaining part */
   if (len < channel->halfw)
-    memcpy(
+    __su_specttuner_copy_bins(
+        self,
         channel->fft + len,
-        self->fft,
-        (channel->halfw - len) * sizeof(SUCOMPLEX));
+        0,
+        channel->halfw - len);
 
   /***************************** Lower sideband ******************************/
   len = channel->halfw;
@@ -778,33 +2039,63 @@ __su_specttuner_feed_channel(
     len = p;   /* Can copy up to p bytes */
 
   /* Copy higher frequencies */
-  memcpy(
+  __su_specttuner_copy_bins(
+      self,
       channel->fft + channel->size - len,
-      self->fft + p - len,
-      len * sizeof(SUCOMPLEX));
+      p - len,
+      len);
 
   /* Copy remaining part */
   if (len < channel->halfw)
-    memcpy(
+    __su_specttuner_copy_bins(
+        self,
         channel->fft + channel->size - channel->halfw,
-        self->fft + window_size - (channel->halfw - len),
-        (channel->halfw - len) * sizeof(SUCOMPLEX));
+        window_size - (channel->halfw - len),
+        channel->halfw - len);
+
+  if (!channel->freq_domain) {
+    /*
+     * Bins are referred to the beginning of the window. If it does not
+     * start at a multiple of the period of the center bin (which never
+     * happens with 50% overlap, as the center bin is always even), the
+     * phase of the center bin at the window start must be compensated
+     * here, along with the scaling.
+     */
+    k = channel->k;
+    rot = ((SUSCOUNT) channel->center * self->hop_phase) % window_size;
+    if (rot != 0)
+      k *= SU_C_EXP(-2 * I * PI * (SUFLOAT) rot / window_size);
 
-  if (channel->params.domain == SU_SPECTTUNER_CHANNEL_TIME_DOMAIN) {
     /*********************** Apply filter and scaling ************************/
 #ifdef SU_SPECTTUNER_SQUARE_FILTER
     for (i = 0; i < channel->halfw; ++i)
-      channel->fft[i] *= channel->k;
+      channel->fft[i] *= k;
 
     for (i = channel->size - channel->halfw; i < channel->size; ++i)
-      channel->fft[i] *= channel->k;
+      channel->fft[i] *= k;
 #else
     for (i = 0; i < channel->halfsz; ++i) {
-      channel->fft[i] *= channel->k * channel->h[i];
+      channel->fft[i] *= k * channel->h[i];
       channel->fft[channel->size - i - 1] *=
-          channel->k * channel->h[window_size - i - 1];
+          k * channel->h[window_size - i - 1];
     }
 #endif
+
+    /*************************** Squelch detection ***************************/
+    if (channel->params.squelch > 0) {
+      channel->power = 0;
+
+      /* Only the copied bins may hold signal */
+      for (i = 0; i < channel->halfw; ++i)
+        channel->power +=
+            SU_C_REAL(channel->fft[i] * SU_C_CONJ(channel->fft[i]))
+            + SU_C_REAL(
+                channel->fft[channel->size - i - 1]
+                * SU_C_CONJ(channel->fft[channel->size - i - 1]));
+
+      channel->power *= channel->gain * channel->gain;
+      channel->squelched = channel->power < channel->params.squelch;
+    }
   } else {
     /* Channel is defined in the frequency domain. This means that we
        do not need to perform get back to the time domain (hence we can
@@ -831,87 +2122,342 @@ __su_specttuner_feed_channel(
     }
   }
 
-  /************************* Back to time domain******************************/
-  SU_FFTW(_execute)(channel->plan[self->state]);
+  /* Back to time domain: performed by the channel group */
+  return SU_TRUE;
+}
 
-  curr = channel->ifft[self->state];
-  prev = channel->ifft[!self->state] + channel->halfsz;
+SUINLINE SUBOOL
+__su_specttuner_finish_channel(
+    const su_specttuner_t *self,
+    su_specttuner_channel_t *channel)
+{
+  SUCOMPLEX *curr;
 
-  /* Glue buffers */
-  if (channel->params.precise) {
-    if (changing_freqs) {
-      /* Do this only when switching frequencies */
-      if (self->params.early_windowing) {
-        /* Windowing already applied, no need to apply it here */
-        for (i = 0; i < channel->halfsz; ++i) {
-          phold = su_ncqo_read(&channel->old_lo);
-          phase = su_ncqo_read(&channel->lo);
-          curr[i] =
-              channel->gain * (phase * curr[i] + phold * prev[i]);
-        }
-      } else {
-        /* Late windowing, need to apply it here */
-        for (i = 0; i < channel->halfsz; ++i) {
-          alpha = channel->window[i];
-          beta = channel->window[i + channel->halfsz];
-
-          phold = su_ncqo_read(&channel->old_lo);
-          phase = su_ncqo_read(&channel->lo);
-          curr[i] =
-              channel->gain * (phase * alpha * curr[i] + phold * beta * prev[i]);
-        }
-      }
-    } else {
-      if (self->params.early_windowing) {
-        /* Early windowing, speed things up */
-        for (i = 0; i < channel->halfsz; ++i) {
-          phase = su_ncqo_read(&channel->lo);
-          curr[i] = channel->gain * phase * (curr[i] + prev[i]);
-        }
-      } else {
-        /* Late windowing, need to apply it here */
-        for (i = 0; i < channel->halfsz; ++i) {
-          alpha = channel->window[i];                  /* Positive slope */
-          beta = channel->window[i + channel->halfsz]; /* Negative slope */
-
-          phase = su_ncqo_read(&channel->lo);
-          curr[i] = channel->gain * phase * (alpha * curr[i] + beta * prev[i]);
-        }
-      }
-    }
-  } else {
-    if (self->params.early_windowing) {
-      /* Early windowing */
-      for (i = 0; i < channel->halfsz; ++i)
-        curr[i] = channel->gain * (a_sign * curr[i] + b_sign * prev[i]);
-    } else {
-      /* Late windowing */
-      for (i = 0; i < channel->halfsz; ++i) {
-        alpha = a_sign * channel->window[i];                  /* Positive slope */
-        beta = b_sign * channel->window[i + channel->halfsz]; /* Negative slope */
+  if (channel->freq_domain)
+    return SU_TRUE;
 
-        curr[i] = channel->gain * (alpha * curr[i] + beta * prev[i]);
-      }
+  curr = channel->ifft;
+
+  if (channel->squelched) {
+    if (channel->silent_tail) {
+      /* Nothing to glue. Just keep the LO in phase. */
+      if (channel->params.precise)
+        __su_specttuner_lo_advance(&channel->lo, channel->hopsz);
+
+      return (channel->params.on_data)(
+          channel,
+          channel->params.privdata,
+          NULL,
+          channel->hopsz);
     }
+
+    /* No inverse FFT for this window: let the previous one fade out */
+    memset(curr, 0, channel->size * sizeof(SU_FFTW(_complex)));
   }
 
+  /* Glue buffers */
+  if (channel->changing_freqs)
+    (channel->glue_retune)(channel, curr);
+  else
+    (channel->glue)(channel, curr);
+
+  /* Keep the overlapping part for the next window */
+  memcpy(
+      channel->tail,
+      curr + channel->hopsz,
+      channel->ovsz * sizeof(SUCOMPLEX));
+  channel->silent_tail = channel->squelched;
+
   /************************** Call user callback *****************************/
   return (channel->params.on_data)(
       channel,
       channel->params.privdata,
       curr,
-      channel->halfsz);
+      channel->hopsz);
 }
 
-SU_METHOD(su_specttuner, SUBOOL, feed_all_channels)
+/*
+ * Each stage is split in slices. Channels (and group batches) are
+ * interleaved across slices, so that channels opened together (and
+ * usually of similar size) end up in different threads.
+ */
+SUPRIVATE SUBOOL
+su_specttuner_prepare_channel_slice(
+    su_specttuner_t *self,
+    unsigned int index,
+    unsigned int count)
 {
   unsigned int i;
   SUBOOL ok = SU_TRUE;
 
+  for (i = index; i < self->channel_count; i += count)
+    ok = __su_specttuner_prepare_channel(self, self->channel_list[i]) && ok;
+
+  return ok;
+}
+
+SUPRIVATE SUBOOL
+su_specttuner_execute_group_slice(
+    su_specttuner_t *self,
+    unsigned int index,
+    unsigned int count)
+{
+  unsigned int i, batch, batches;
+  unsigned int n = 0;
+
+  for (i = 0; i < self->group_count; ++i)
+    if (self->group_list[i] != NULL) {
+      batches = __su_specttuner_group_get_batch_count(self->group_list[i]);
+      for (batch = 0; batch < batches; ++batch)
+        if (n++ % count == index)
+          __su_specttuner_group_execute(self->group_list[i], batch);
+    }
+
+  return SU_TRUE;
+}
+
+SUPRIVATE SUBOOL
+su_specttuner_finish_channel_slice(
+    su_specttuner_t *self,
+    unsigned int index,
+    unsigned int count)
+{
+  unsigned int i;
+  SUBOOL ok = SU_TRUE;
+
+  for (i = index; i < self->channel_count; i += count)
+    ok = __su_specttuner_finish_channel(self, self->channel_list[i]) && ok;
+
+  return ok;
+}
+
+/* Leave squelched channels out of the batches of this window */
+SUPRIVATE
+SU_METHOD(su_specttuner, void, sort_groups)
+{
+  unsigned int i;
+
+  for (i = 0; i < self->group_count; ++i)
+    if (self->group_list[i] != NULL)
+      su_specttuner_group_sort_active(self->group_list[i]);
+}
+
+/* Leave frequency-domain channels out of the batches of this window */
+SUPRIVATE
+SU_METHOD(su_specttuner, void, sort_domains)
+{
+  unsigned int i;
+
+  for (i = 0; i < self->group_count; ++i)
+    if (self->group_list[i] != NULL)
+      su_specttuner_group_sort_domains(self->group_list[i]);
+}
+
+/***************************** Channel commands *****************************/
+/* Asks the planner for the plans of the group it has not computed yet */
+SUPRIVATE
+SU_METHOD(su_specttuner, void, request_plans, su_specttuner_group_t *group)
+{
+  su_specttuner_command_t *job;
+  unsigned int i;
+
+  for (i = 0; i < group->plan_count; ++i) {
+    if ((group->requested | group->measured) & (1u << i))
+      continue;
+
+    SU_ALLOCATE_CATCH(job, su_specttuner_command_t, return);
+
+    job->type  = SU_SPECTTUNER_COMMAND_PLAN;
+    job->group = group;
+    job->size  = group->size;
+    job->index = i;
+
+    group->requested |= 1u << i;
+
+    su_specttuner_planner_post(self->planner, job);
+  }
+}
+
+/*
+ * The group may have been released before the plan arrived. Plans
+ * only depend on the transform size, so whatever group we find at that
+ * address with that size can still use it.
+ */
+SUPRIVATE
+SU_METHOD(su_specttuner, void, swap_plan, su_specttuner_command_t *cmd)
+{
+  su_specttuner_group_t *group = NULL;
+  unsigned int i;
+
+  for (i = 0; i < self->group_count; ++i)
+    if (self->group_list[i] == cmd->group) {
+      group = cmd->group;
+      break;
+    }
+
+  if (group != NULL
+      && group->size == cmd->size
+      && cmd->index < group->plan_count
+      && !(group->measured & (1u << cmd->index))) {
+    su_specttuner_release_plan(self, group->plan_list[cmd->index]);
+    group->plan_list[cmd->index] = cmd->plan;
+    group->measured |= 1u << cmd->index;
+  } else {
+    su_specttuner_release_plan(self, cmd->plan);
+  }
+}
+
+SUPRIVATE
+SU_METHOD(
+    su_specttuner,
+    SUBOOL,
+    attach_channel,
+    su_specttuner_channel_t *channel)
+{
+  su_specttuner_group_t *group = NULL;
+  int index;
+
+  SU_TRY_FAIL(group = su_specttuner_assert_group(self, channel->size));
+  SU_TRY_FAIL(su_specttuner_group_add(group, channel));
+
+  SU_TRYC_FAIL(index = PTR_SLOTMAP_INSERT(self->channel, channel));
+
+  channel->index = index;
+
+  ++self->count;
+
+  if (group->deferred) {
+    if (group->plan_list[0] == NULL) {
+      group->plan_list[0] = channel->seed_plan;
+    } else {
+      su_specttuner_release_plan(self, channel->seed_plan);
+    }
+
+    channel->seed_plan = NULL;
+
+    su_specttuner_request_plans(self, group);
+  }
+
+  return SU_TRUE;
+
+fail:
+  if (channel->group != NULL)
+    su_specttuner_group_remove(channel->group, channel);
+
+  if (group != NULL)
+    su_specttuner_release_group(self, group);
+
+  return SU_FALSE;
+}
+
+/* Lock-free push, callable from any thread */
+SUPRIVATE
+SU_METHOD(
+    su_specttuner,
+    SUBOOL,
+    post_command,
+    enum sigutils_specttuner_command_type type,
+    su_specttuner_channel_t *channel,
+    SUFLOAT value)
+{
+  su_specttuner_command_t *cmd = NULL;
+
+  SU_ALLOCATE_CATCH(cmd, su_specttuner_command_t, return SU_FALSE);
+
+  cmd->type    = type;
+  cmd->channel = channel;
+  cmd->value   = value;
+
+  __su_specttuner_command_push(&self->commands, cmd);
+
+  return SU_TRUE;
+}
+
+/* Runs all pending commands. Called from the feeding thread only. */
+SUPRIVATE
+SU_METHOD(su_specttuner, void, run_commands)
+{
+  su_specttuner_command_t *queue, *cmd;
+  su_specttuner_channel_t *channel;
+
+  queue = __su_specttuner_command_pop_all(&self->commands);
+
+  while ((cmd = queue) != NULL) {
+    queue = cmd->next;
+    channel = cmd->channel;
+
+    switch (cmd->type) {
+      case SU_SPECTTUNER_COMMAND_OPEN:
+        /* Channels that cannot be attached stay idle until closed */
+        if (!su_specttuner_attach_channel(self, channel))
+          SU_ERROR("Cannot attach channel to tuner\n");
+        break;
+
+      case SU_SPECTTUNER_COMMAND_CLOSE:
+        if (channel->index >= 0) {
+          (void) su_specttuner_close_channel(self, channel);
+        } else {
+          su_specttuner_release_plan(self, channel->seed_plan);
+          channel->seed_plan = NULL;
+          su_specttuner_channel_destroy(channel);
+        }
+        break;
+
+      case SU_SPECTTUNER_COMMAND_SET_FREQ:
+        su_specttuner_set_channel_freq(self, channel, cmd->value);
+        break;
+
+      case SU_SPECTTUNER_COMMAND_SET_DELTA_F:
+        su_specttuner_set_channel_delta_f(self, channel, cmd->value);
+        break;
+
+      case SU_SPECTTUNER_COMMAND_SWAP_PLAN:
+        su_specttuner_swap_plan(self, cmd);
+        break;
+
+      default:
+        break;
+    }
+
+    free(cmd);
+  }
+}
+
+SUPRIVATE
+SU_METHOD(su_specttuner, SUBOOL, feed_channels)
+{
+  SUBOOL ok = SU_TRUE;
+
+  su_specttuner_run_commands(self);
+  su_specttuner_sort_domains(self);
+
+  if (self->pool != NULL) {
+    ok = su_specttuner_pool_run(
+        self->pool,
+        su_specttuner_prepare_channel_slice) && ok;
+    su_specttuner_sort_groups(self);
+    ok = su_specttuner_pool_run(
+        self->pool,
+        su_specttuner_execute_group_slice) && ok;
+    ok = su_specttuner_pool_run(
+        self->pool,
+        su_specttuner_finish_channel_slice) && ok;
+  } else {
+    ok = su_specttuner_prepare_channel_slice(self, 0, 1) && ok;
+    su_specttuner_sort_groups(self);
+    ok = su_specttuner_execute_group_slice(self, 0, 1) && ok;
+    ok = su_specttuner_finish_channel_slice(self, 0, 1) && ok;
+  }
+
+  return ok;
+}
+
+SU_METHOD(su_specttuner, SUBOOL, feed_all_channels)
+{
+  SUBOOL ok = SU_TRUE;
+
   if (su_specttuner_new_data(self)) {
-    for (i = 0; i < self->channel_count; ++i)
-      if (self->channel_list[i] != NULL)
-        ok = __su_specttuner_feed_channel(self, self->channel_list[i]) && ok;
+    ok = su_specttuner_feed_channels(self);
     su_specttuner_ack_data(self);
   }
 
@@ -925,19 +2471,9 @@ SU_METHOD(su_specttuner, SUBOOL, feed_all_channels)
 
 SU_METHOD(su_specttuner, SUBOOL, trigger, su_specttuner_plan_t *plan)
 {
-  unsigned int i;
-  SUBOOL ok = SU_TRUE;
-
-  self->p = self->half_size;
-  su_specttuner_run_fft(self, plan);
-  self->state = !self->state;
-  self->ready = SU_TRUE;
+  su_specttuner_complete_window(self, plan);
 
-  for (i = 0; i < self->channel_count; ++i)
-    if (self->channel_list[i] != NULL)
-      ok = __su_specttuner_feed_channel(self, self->channel_list[i]) && ok;
-
-  return ok;
+  return su_specttuner_feed_channels(self);
 }
 
 SU_METHOD(
@@ -949,18 +2485,51 @@ SU_METHOD(
 {
   SUSDIFF got;
   SUSCOUNT ok = SU_TRUE;
-  unsigned int i;
 
   if (self->ready)
     return 0;
 
-  got = __su_specttuner_feed_bulk(self, buf, size);
+  SU_TRYCATCH(!self->params.real_input, return -1);
+
+  got = __su_specttuner_feed_bulk(
+      self,
+      self->buffer,
+      sizeof(SUCOMPLEX),
+      buf,
+      size);
 
   /* Buffer full, feed channels */
   if (self->ready)
-    for (i = 0; i < self->channel_count; ++i)
-      if (self->channel_list[i] != NULL)
-        ok = __su_specttuner_feed_channel(self, self->channel_list[i]) && ok;
+    ok = su_specttuner_feed_channels(self);
+
+  return ok ? got : -1;
+}
+
+SU_METHOD(
+    su_specttuner,
+    SUSDIFF,
+    feed_bulk_single_real,
+    const SUFLOAT *__restrict buf,
+    SUSCOUNT size)
+{
+  SUSDIFF got;
+  SUSCOUNT ok = SU_TRUE;
+
+  if (self->ready)
+    return 0;
+
+  SU_TRYCATCH(self->params.real_input, return -1);
+
+  got = __su_specttuner_feed_bulk(
+      self,
+      self->real_buffer,
+      sizeof(SUFLOAT),
+      buf,
+      size);
+
+  /* Buffer full, feed channels */
+  if (self->ready)
+    ok = su_specttuner_feed_channels(self);
 
   return ok ? got : -1;
 }
@@ -991,6 +2560,77 @@ SU_METHOD(
   return ok;
 }
 
+SU_METHOD(
+    su_specttuner,
+    SUBOOL,
+    feed_bulk_real,
+    const SUFLOAT *__restrict buf,
+    SUSCOUNT size)
+{
+  SUSDIFF got;
+  SUBOOL ok = SU_TRUE;
+
+  while (size > 0) {
+    got = su_specttuner_feed_bulk_single_real(self, buf, size);
+
+    if (su_specttuner_new_data(self))
+      su_specttuner_ack_data(self);
+
+    if (got == -1)
+      return SU_FALSE;
+
+    buf += got;
+    size -= got;
+  }
+
+  return ok;
+}
+
+SU_METHOD(su_specttuner, SUCOMPLEX *, acquire, SUSCOUNT *avail)
+{
+  SU_TRYCATCH(!self->params.real_input, return NULL);
+  SU_TRYCATCH(!self->ready, return NULL);
+
+  return __su_specttuner_get_span(
+      self,
+      self->buffer,
+      sizeof(SUCOMPLEX),
+      avail);
+}
+
+SU_METHOD(su_specttuner, SUFLOAT *, acquire_real, SUSCOUNT *avail)
+{
+  SU_TRYCATCH(self->params.real_input, return NULL);
+  SU_TRYCATCH(!self->ready, return NULL);
+
+  return __su_specttuner_get_span(
+      self,
+      self->real_buffer,
+      sizeof(SUFLOAT),
+      avail);
+}
+
+SU_METHOD(su_specttuner, SUBOOL, commit, SUSCOUNT size)
+{
+  SUBOOL ok = SU_TRUE;
+
+  SU_TRYCATCH(!self->ready, return SU_FALSE);
+  SU_TRYCATCH(self->p + size <= self->params.window_size, return SU_FALSE);
+
+  if (self->params.real_input)
+    __su_specttuner_commit(self, self->real_buffer, sizeof(SUFLOAT), size);
+  else
+    __su_specttuner_commit(self, self->buffer, sizeof(SUCOMPLEX), size);
+
+  /* Window complete, feed channels */
+  if (self->ready) {
+    ok = su_specttuner_feed_channels(self);
+    su_specttuner_ack_data(self);
+  }
+
+  return ok;
+}
+
 SU_METHOD(
     su_specttuner,
     su_specttuner_channel_t *,
@@ -998,15 +2638,10 @@ SU_METHOD(
     const struct sigutils_specttuner_channel_params *params)
 {
   su_specttuner_channel_t *new = NULL;
-  int index;
 
   SU_MAKE_FAIL(new, su_specttuner_channel, self, params);
 
-  SU_TRYC_FAIL(index = PTR_LIST_APPEND_CHECK(self->channel, new));
-
-  new->index = index;
-
-  ++self->count;
+  SU_TRY_FAIL(su_specttuner_attach_channel(self, new));
 
   return new;
 
@@ -1023,13 +2658,17 @@ SU_METHOD(
     close_channel,
     su_specttuner_channel_t *channel)
 {
-  SU_TRYCATCH(channel->index >= 0, return SU_FALSE);
+  su_specttuner_group_t *group;
 
-  SU_TRYCATCH(channel->index < self->channel_count, return SU_FALSE);
+  SU_TRYCATCH(
+      PTR_SLOTMAP_GET(self->channel, channel->index) == channel,
+      return SU_FALSE);
 
-  SU_TRYCATCH(self->channel_list[channel->index] == channel, return SU_FALSE);
+  PTR_SLOTMAP_REMOVE(self->channel, channel->index);
 
-  self->channel_list[channel->index] = NULL;
+  group = channel->group;
+  su_specttuner_group_remove(group, channel);
+  su_specttuner_release_group(self, group);
 
   su_specttuner_channel_destroy(channel);
 
@@ -1037,3 +2676,67 @@ SU_METHOD(
 
   return SU_TRUE;
 }
+
+SU_METHOD(
+    su_specttuner,
+    su_specttuner_channel_t *,
+    open_channel_async,
+    const struct sigutils_specttuner_channel_params *params)
+{
+  su_specttuner_channel_t *new = NULL;
+
+  /* The expensive part (filter design, allocations) happens here */
+  SU_MAKE_FAIL(new, su_specttuner_channel, self, params);
+
+  SU_TRY_FAIL(
+      su_specttuner_post_command(self, SU_SPECTTUNER_COMMAND_OPEN, new, 0));
+
+  return new;
+
+fail:
+  if (new != NULL)
+    su_specttuner_channel_destroy(new);
+
+  return NULL;
+}
+
+SU_METHOD(
+    su_specttuner,
+    SUBOOL,
+    close_channel_async,
+    su_specttuner_channel_t *channel)
+{
+  return su_specttuner_post_command(
+      self,
+      SU_SPECTTUNER_COMMAND_CLOSE,
+      channel,
+      0);
+}
+
+SU_METHOD(
+    su_specttuner,
+    SUBOOL,
+    set_channel_freq_async,
+    su_specttuner_channel_t *channel,
+    SUFLOAT f0)
+{
+  return su_specttuner_post_command(
+      self,
+      SU_SPECTTUNER_COMMAND_SET_FREQ,
+      channel,
+      f0);
+}
+
+SU_METHOD(
+    su_specttuner,
+    SUBOOL,
+    set_channel_delta_f_async,
+    su_specttuner_channel_t *channel,
+    SUFLOAT delta_f)
+{
+  return su_specttuner_post_command(
+      self,
+      SU_SPECTTUNER_COMMAND_SET_DELTA_F,
+      channel,
+      delta_f);
+}
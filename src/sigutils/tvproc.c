@@ -46,7 +46,7 @@ SU_INSTANCER(
     coef[i] = peak - base;
 
   SU_CONSTRUCT_FAIL(
-      su_iir_filt,
+      su_iir_rfilt,
       &new->corr,
       0,    /* y_size */
       NULL, /* y_coef */
@@ -82,7 +82,7 @@ SU_METHOD(su_pulse_finder, SUBOOL, feed, SUFLOAT x)
 
   x -= self->base;
 
-  y = SU_C_REAL(su_iir_filt_feed(&self->corr, x));
+  y = su_iir_rfilt_feed(&self->corr, x);
 
   match = y > self->peak_thr;
 
@@ -116,7 +116,7 @@ SU_GETTER(su_pulse_finder, SUFLOAT, get_pos)
 
 SU_COLLECTOR(su_pulse_finder)
 {
-  SU_DESTRUCT(su_iir_filt, &self->corr);
+  SU_DESTRUCT(su_iir_rfilt, &self->corr);
 
   free(self);
 }
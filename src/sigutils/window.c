@@ -0,0 +1,304 @@
+/*
+
+  Copyright (C) 2026 Gonzalo José Carracedo Carballal
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, version 3.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this program.  If not, see
+  <http://www.gnu.org/licenses/>
+
+*/
+
+#define SU_LOG_DOMAIN "window"
+
+#include <sigutils/window.h>
+
+#include <string.h>
+
+#include <sigutils/log.h>
+#include <sigutils/refcache.h>
+#include <sigutils/taps.h>
+
+/* Not in sigutils_window_kind: also keyed by the overlap */
+#define SU_WINDOW_KIND_OVERLAP -1
+
+struct sigutils_window_cache_entry {
+  struct sigutils_refcache_entry header; /* data: table, size: bytes */
+
+  int      kind;
+  SUSCOUNT size;
+  SUSCOUNT overlap;
+  SUBOOL   is_complex;
+
+  void *table;
+};
+
+SUPRIVATE void
+su_window_compute_overlap(SUFLOAT *w, SUSCOUNT size, SUSCOUNT overlap)
+{
+  SUSCOUNT hop = size - overlap;
+  SUSCOUNT i, j;
+  SUFLOAT s;
+
+  for (i = 0; i < size; ++i) {
+    if (i >= overlap && i < hop) {
+      w[i] = 1;
+    } else {
+      /* Falling slope: continue the rising one */
+      j = i >= hop ? i - (hop - overlap) : i;
+      s = SU_SIN(PI * (SUFLOAT)j / (2 * overlap));
+      w[i] = s * s;
+    }
+  }
+}
+
+SUPRIVATE SUBOOL
+su_window_compute_real(SUFLOAT *w, int kind, SUSCOUNT size)
+{
+  SUSCOUNT i;
+
+  for (i = 0; i < size; ++i)
+    w[i] = 1;
+
+  switch (kind) {
+    case SU_WINDOW_RECTANGULAR:
+      break;
+
+    case SU_WINDOW_HAMMING:
+      su_taps_apply_hamming(w, size);
+      break;
+
+    case SU_WINDOW_HANN:
+      su_taps_apply_hann(w, size);
+      break;
+
+    case SU_WINDOW_FLAT_TOP:
+      su_taps_apply_flat_top(w, size);
+      break;
+
+    case SU_WINDOW_BLACKMANN_HARRIS:
+      su_taps_apply_blackmann_harris(w, size);
+      break;
+
+    default:
+      SU_WARNING("Unsupported window function %d\n", kind);
+      return SU_FALSE;
+  }
+
+  return SU_TRUE;
+}
+
+SUPRIVATE SUBOOL
+su_window_compute_complex(SUCOMPLEX *w, int kind, SUSCOUNT size)
+{
+  SUSCOUNT i;
+
+  for (i = 0; i < size; ++i)
+    w[i] = 1;
+
+  switch (kind) {
+    case SU_WINDOW_RECTANGULAR:
+      break;
+
+    case SU_WINDOW_HAMMING:
+      su_taps_apply_hamming_complex(w, size);
+      break;
+
+    case SU_WINDOW_HANN:
+      su_taps_apply_hann_complex(w, size);
+      break;
+
+    case SU_WINDOW_FLAT_TOP:
+      su_taps_apply_flat_top_complex(w, size);
+      break;
+
+    case SU_WINDOW_BLACKMANN_HARRIS:
+      su_taps_apply_blackmann_harris_complex(w, size);
+      break;
+
+    default:
+      SU_WARNING("Unsupported window function %d\n", kind);
+      return SU_FALSE;
+  }
+
+  return SU_TRUE;
+}
+
+/* Computes the table described by the key of entry */
+SUPRIVATE SUBOOL
+su_window_cache_entry_compute(struct sigutils_window_cache_entry *entry)
+{
+  SUBOOL ok = SU_FALSE;
+
+  entry->header.size =
+      entry->size * (entry->is_complex ? sizeof(SUCOMPLEX) : sizeof(SUFLOAT));
+
+  SU_TRY(entry->table = SU_FFTW(_malloc)(entry->header.size));
+
+  if (entry->kind == SU_WINDOW_KIND_OVERLAP) {
+    su_window_compute_overlap(entry->table, entry->size, entry->overlap);
+  } else if (entry->is_complex) {
+    SU_TRY(su_window_compute_complex(entry->table, entry->kind, entry->size));
+  } else {
+    SU_TRY(su_window_compute_real(entry->table, entry->kind, entry->size));
+  }
+
+  ok = SU_TRUE;
+
+done:
+  return ok;
+}
+
+SUPRIVATE SUBOOL
+su_window_cache_entry_match(
+    const struct sigutils_refcache_entry *header,
+    const void *key)
+{
+  const struct sigutils_window_cache_entry *entry =
+      (const struct sigutils_window_cache_entry *)header;
+  const struct sigutils_window_cache_entry *k =
+      (const struct sigutils_window_cache_entry *)key;
+
+  return entry->kind       == k->kind
+      && entry->size       == k->size
+      && entry->overlap    == k->overlap
+      && entry->is_complex == k->is_complex;
+}
+
+SUPRIVATE void
+su_window_cache_entry_destroy(struct sigutils_refcache_entry *header)
+{
+  struct sigutils_window_cache_entry *entry =
+      (struct sigutils_window_cache_entry *)header;
+
+  if (entry->table != NULL)
+    SU_FFTW(_free)(entry->table);
+
+  free(entry);
+}
+
+SUPRIVATE struct sigutils_refcache_entry *
+su_window_cache_entry_create(const void *key)
+{
+  struct sigutils_window_cache_entry *entry = NULL;
+
+  SU_ALLOCATE(entry, struct sigutils_window_cache_entry);
+  *entry = *(const struct sigutils_window_cache_entry *)key;
+
+  SU_TRY(su_window_cache_entry_compute(entry));
+
+  entry->header.data = entry->table;
+
+  return &entry->header;
+
+done:
+  if (entry != NULL)
+    su_window_cache_entry_destroy(&entry->header);
+
+  return NULL;
+}
+
+SUPRIVATE const struct sigutils_refcache_class g_window_cache_class = {
+    su_window_cache_entry_match,
+    su_window_cache_entry_create,
+    su_window_cache_entry_destroy,
+    SU_WINDOW_CACHE_MAX_IDLE,
+    SU_WINDOW_CACHE_MAX_IDLE_SIZE};
+
+SUPRIVATE su_refcache_t g_window_cache =
+    su_refcache_INITIALIZER(&g_window_cache_class);
+
+/* Looks up a table matching key, computing it if necessary */
+SUPRIVATE const void *
+su_window_acquire_table(const struct sigutils_window_cache_entry *key)
+{
+  const struct sigutils_window_cache_entry *entry;
+
+  SU_TRYCATCH(key->size > 0, return NULL);
+
+  entry = (const struct sigutils_window_cache_entry *)su_refcache_acquire(
+      &g_window_cache,
+      key);
+
+  return entry != NULL ? entry->table : NULL;
+}
+
+SUINLINE void
+su_window_key_init(
+    struct sigutils_window_cache_entry *key,
+    int kind,
+    SUSCOUNT size,
+    SUSCOUNT overlap,
+    SUBOOL is_complex)
+{
+  memset(key, 0, sizeof(struct sigutils_window_cache_entry));
+
+  key->kind       = kind;
+  key->size       = size;
+  key->overlap    = overlap;
+  key->is_complex = is_complex;
+}
+
+const SUFLOAT *
+su_window_acquire(enum sigutils_window_kind kind, SUSCOUNT size)
+{
+  struct sigutils_window_cache_entry key;
+
+  su_window_key_init(&key, kind, size, 0, SU_FALSE);
+
+  return su_window_acquire_table(&key);
+}
+
+const SUCOMPLEX *
+su_window_acquire_complex(enum sigutils_window_kind kind, SUSCOUNT size)
+{
+  struct sigutils_window_cache_entry key;
+
+  su_window_key_init(&key, kind, size, 0, SU_TRUE);
+
+  return su_window_acquire_table(&key);
+}
+
+const SUFLOAT *
+su_window_acquire_overlap(SUSCOUNT size, SUSCOUNT overlap)
+{
+  struct sigutils_window_cache_entry key;
+
+  SU_TRYCATCH(overlap > 0 && 2 * overlap <= size, return NULL);
+
+  su_window_key_init(&key, SU_WINDOW_KIND_OVERLAP, size, overlap, SU_FALSE);
+
+  return su_window_acquire_table(&key);
+}
+
+void
+su_window_release(const void *table)
+{
+  if (table == NULL)
+    return;
+
+  if (!su_refcache_release(&g_window_cache, table))
+    SU_WARNING("Releasing a window that does not belong to the cache\n");
+}
+
+void
+su_window_get_cache_stats(struct sigutils_window_cache_stats *stats)
+{
+  struct sigutils_refcache_stats cache_stats;
+
+  su_refcache_get_stats(&g_window_cache, &cache_stats);
+
+  stats->hits    = cache_stats.hits;
+  stats->misses  = cache_stats.misses;
+  stats->entries = cache_stats.entries;
+  stats->idle    = cache_stats.idle;
+  stats->size    = cache_stats.size;
+}
@@ -250,6 +250,130 @@ ptr_list_remove_all(void ***list, int *count, void *ptr)
   return found;
 }
 
+void
+ptr_slotmap_finalize(void ***list, unsigned int *count, ptr_slotmap_t *map)
+{
+  if (*list != NULL)
+    free(*list);
+
+  if (map->slot != NULL)
+    free(map->slot);
+
+  if (map->handle != NULL)
+    free(map->handle);
+
+  *list = NULL;
+  *count = 0;
+  memset(map, 0, sizeof(ptr_slotmap_t));
+}
+
+static int
+ptr_slotmap_grow(void ***list, ptr_slotmap_t *map)
+{
+  unsigned int alloc = map->alloc > 0 ? map->alloc << 1 : 8;
+  void *tmp;
+
+  if ((tmp = realloc(*list, alloc * sizeof(void *))) == NULL)
+    return -1;
+  *list = tmp;
+
+  if ((tmp = realloc(map->slot, alloc * sizeof(unsigned int))) == NULL)
+    return -1;
+  map->slot = tmp;
+
+  if ((tmp = realloc(map->handle, alloc * sizeof(unsigned int))) == NULL)
+    return -1;
+  map->handle = tmp;
+
+  map->alloc = alloc;
+
+  return 0;
+}
+
+int
+ptr_slotmap_insert(
+    void ***list,
+    unsigned int *count,
+    ptr_slotmap_t *map,
+    void *ptr)
+{
+  unsigned int h;
+
+  if (map->next_free > 0) {
+    /* Reuse the most recently released handle */
+    h = map->next_free - 1;
+    map->next_free = map->slot[h];
+  } else {
+    if (map->handles == map->alloc)
+      if (ptr_slotmap_grow(list, map) == -1)
+        return -1;
+
+    h = map->handles++;
+  }
+
+  (*list)[*count] = ptr;
+  map->handle[*count] = h;
+  map->slot[h] = (*count)++;
+
+  return h;
+}
+
+void *
+ptr_slotmap_get(
+    void **list,
+    unsigned int count,
+    const ptr_slotmap_t *map,
+    int handle)
+{
+  unsigned int pos;
+
+  if (handle < 0 || (unsigned int)handle >= map->handles)
+    return NULL;
+
+  pos = map->slot[handle];
+
+  if (pos >= count || map->handle[pos] != (unsigned int)handle)
+    return NULL;
+
+  return list[pos];
+}
+
+void
+ptr_slotmap_remove_at(
+    void **list,
+    unsigned int *count,
+    ptr_slotmap_t *map,
+    unsigned int pos)
+{
+  unsigned int h = map->handle[pos];
+  unsigned int last = --*count;
+
+  /* Fill the hole with the last element */
+  list[pos] = list[last];
+  map->handle[pos] = map->handle[last];
+  map->slot[map->handle[pos]] = pos;
+  list[last] = NULL;
+
+  /* Released handles are chained through the slot table */
+  map->slot[h] = map->next_free;
+  map->next_free = h + 1;
+}
+
+int
+ptr_slotmap_remove(
+    void **list,
+    unsigned int *count,
+    ptr_slotmap_t *map,
+    int handle)
+{
+  if (ptr_slotmap_get(list, *count, map, handle) == NULL)
+    return 0;
+
+  ptr_slotmap_remove_at(list, count, map, map->slot[handle]);
+
+  return 1;
+}
+
 char *
 str_append_char(char *source, char c)
 {
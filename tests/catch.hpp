@@ -6,7 +6,6 @@
 #define _CATCH_TEST_H
 
 #ifdef CATCH2_V2
-    #define CATCH_CONFIG_MAIN
     #include <catch2/catch.hpp>
 #endif
 
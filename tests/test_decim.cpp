@@ -0,0 +1,122 @@
+/* SPDX-License-Identifier: GPL-3.0-only */
+
+#include "catch.hpp"
+
+#include <sigutils/decim.h>
+#include <sigutils/iir.h>
+#include <sigutils/softtune.h>
+#include <sigutils/taps.h>
+
+#define DECIM_TEST_LEN 4000
+
+static SUCOMPLEX
+test_signal(unsigned int i)
+{
+  if (i == 0)
+    return 1;
+
+  return SUCOMPLEX(cos(.0123 * i), sin(.0123 * i))
+         + SUCOMPLEX(.5 * cos(.731 * i), -.5 * sin(.731 * i));
+}
+
+/* Full-rate FIR with the same taps, keeping every D-th output */
+static void
+compare_decim_with_fir(unsigned int decimation, unsigned int taps)
+{
+  static const SUSCOUNT blocks[] = {1, 7, 64, 333, 1000};
+  su_decim_t decim = su_decim_INITIALIZER;
+  su_iir_filt_t fir = su_iir_filt_INITIALIZER;
+  SUFLOAT *h = NULL;
+  SUCOMPLEX x[1000], y[1000], out[1000];
+  SUSCOUNT n, got;
+  unsigned int i, j, k = 0, p = 0;
+
+  h = (SUFLOAT *)malloc(taps * sizeof(SUFLOAT));
+  REQUIRE(h != NULL);
+
+  su_taps_brickwall_lp_init(h, SU_ADDSFX(.8) / decimation, taps);
+
+  REQUIRE(su_decim_init(&decim, decimation, h, taps));
+  REQUIRE(su_iir_filt_init(&fir, 0, NULL, taps, h));
+
+  while (p < DECIM_TEST_LEN)
+    for (i = 0; i < sizeof(blocks) / sizeof(blocks[0]); ++i) {
+      for (j = 0; j < blocks[i]; ++j)
+        x[j] = test_signal(p + j);
+
+      n = su_decim_get_output_size(&decim, blocks[i]);
+      got = su_decim_feed_bulk(&decim, x, blocks[i], out);
+      REQUIRE(got == n);
+
+      su_iir_filt_feed_bulk(&fir, x, y, blocks[i]);
+
+      /* Outputs are produced after the last sample of every D inputs */
+      for (j = 0; j < blocks[i]; ++j, ++p)
+        if (p % decimation == decimation - 1) {
+          REQUIRE(k < n);
+          REQUIRE(SU_C_ABS(out[k++] - y[j]) < 1e-4);
+        }
+
+      REQUIRE(k == n);
+      k = 0;
+    }
+
+  su_decim_finalize(&decim);
+  su_iir_filt_finalize(&fir);
+  free(h);
+}
+
+TEST_CASE("Test decimation against full-rate filtering", "[Decim]")
+{
+  compare_decim_with_fir(2, 31);
+  compare_decim_with_fir(5, 40);
+  compare_decim_with_fir(10, 80);
+  compare_decim_with_fir(16, 33);
+}
+
+/* Mean power of the outputs, once the filter is full */
+static SUFLOAT
+decim_tone_power(su_decim_t *decim, SUFLOAT fnor)
+{
+  SUCOMPLEX x[DECIM_TEST_LEN], out[DECIM_TEST_LEN];
+  SUSCOUNT n, skip;
+  SUFLOAT power = 0;
+  unsigned int i;
+
+  for (i = 0; i < DECIM_TEST_LEN; ++i)
+    x[i] = SUCOMPLEX(cos(M_PI * fnor * i), sin(M_PI * fnor * i));
+
+  su_decim_reset(decim);
+  n = su_decim_feed_bulk(decim, x, DECIM_TEST_LEN, out);
+  skip = decim->taps / su_decim_get_decimation(decim) + 1;
+
+  REQUIRE(n > skip);
+
+  for (i = skip; i < n; ++i)
+    power += SU_C_REAL(out[i] * SU_C_CONJ(out[i]));
+
+  return power / (n - skip);
+}
+
+TEST_CASE("Test softtuner decimator response", "[Decim]")
+{
+  su_decim_t decim = su_decim_INITIALIZER;
+  unsigned int decimation = 10;
+
+  REQUIRE(su_decim_init_lowpass(
+      &decim,
+      decimation,
+      SU_SOFTTUNER_POLYPHASE_TAPS_PER_PHASE,
+      (1 - SU_SOFTTUNER_POLYPHASE_TRANSITION) / decimation));
+
+  /* Unity gain at DC, flat over half the output band */
+  REQUIRE(SU_ABS(decim_tone_power(&decim, 0) - 1) < 1e-3);
+  REQUIRE(SU_POWER_DB(decim_tone_power(&decim, .5 / decimation)) > -.5);
+
+  /* Nothing beyond the output Nyquist frequency folds back */
+  REQUIRE(SU_POWER_DB(decim_tone_power(&decim, 1. / decimation)) < -45);
+  REQUIRE(SU_POWER_DB(decim_tone_power(&decim, 1.1 / decimation)) < -45);
+  REQUIRE(SU_POWER_DB(decim_tone_power(&decim, 1.5 / decimation)) < -45);
+
+  su_decim_finalize(&decim);
+}
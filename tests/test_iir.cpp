@@ -0,0 +1,309 @@
+/* SPDX-License-Identifier: GPL-3.0-only */
+
+#include "catch.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sigutils/iir.h>
+#include <sigutils/coef.h>
+#include <sigutils/taps.h>
+
+/* Impulse followed by a few tones, to excite the whole band */
+static SUCOMPLEX
+test_signal(unsigned int i)
+{
+  if (i == 0)
+    return 1;
+
+  return SUCOMPLEX(cos(.05 * i) + .5 * cos(.7 * i), .3 * sin(2.1 * i));
+}
+
+/* Build the transfer function of the filter in direct form */
+static void
+direct_form_init(
+    su_iir_filt_t *filt,
+    SUSCOUNT size,
+    SUFLOAT *a,
+    SUFLOAT *b,
+    SUFLOAT scaling)
+{
+  unsigned int i;
+
+  for (i = 0; i < size; ++i)
+    b[i] *= scaling;
+
+  REQUIRE(su_iir_filt_init(filt, size, a, size, b));
+
+  free(a);
+  free(b);
+}
+
+static void
+compare_with_direct_form(su_iir_filt_t *sos, su_iir_filt_t *direct)
+{
+  SUCOMPLEX x, y;
+  unsigned int i;
+
+  REQUIRE(sos->sos_count > 0);
+
+  for (i = 0; i < 2000; ++i) {
+    x = test_signal(i);
+    y = su_iir_filt_feed(direct, x);
+    REQUIRE(SU_C_ABS(su_iir_filt_feed(sos, x) - y) < 1e-3);
+  }
+
+  su_iir_filt_finalize(sos);
+  su_iir_filt_finalize(direct);
+}
+
+TEST_CASE("Test SOS low-pass against direct form", "[IIR]")
+{
+  su_iir_filt_t sos = su_iir_filt_INITIALIZER;
+  su_iir_filt_t direct = su_iir_filt_INITIALIZER;
+
+  REQUIRE(su_iir_bwlpf_init(&sos, 4, .2));
+  direct_form_init(
+      &direct,
+      5,
+      su_dcof_bwlp(4, .2),
+      su_ccof_bwlp(4),
+      su_sf_bwlp(4, .2));
+
+  compare_with_direct_form(&sos, &direct);
+}
+
+TEST_CASE("Test SOS high-pass against direct form", "[IIR]")
+{
+  su_iir_filt_t sos = su_iir_filt_INITIALIZER;
+  su_iir_filt_t direct = su_iir_filt_INITIALIZER;
+
+  REQUIRE(su_iir_bwhpf_init(&sos, 4, .3));
+  direct_form_init(
+      &direct,
+      5,
+      su_dcof_bwhp(4, .3),
+      su_ccof_bwhp(4),
+      su_sf_bwhp(4, .3));
+
+  compare_with_direct_form(&sos, &direct);
+}
+
+TEST_CASE("Test SOS band-pass against direct form", "[IIR]")
+{
+  su_iir_filt_t sos = su_iir_filt_INITIALIZER;
+  su_iir_filt_t direct = su_iir_filt_INITIALIZER;
+
+  REQUIRE(su_iir_bwbpf_init(&sos, 3, .2, .4));
+  direct_form_init(
+      &direct,
+      7,
+      su_dcof_bwbp(3, .2, .4),
+      su_ccof_bwbp(3),
+      su_sf_bwbp(3, .2, .4));
+
+  compare_with_direct_form(&sos, &direct);
+}
+
+/* Feeds fast convolution blocks shorter and longer than its FFT block */
+static void
+compare_ols_with_direct(su_iir_filt_t *ols, const SUFLOAT *taps, SUSCOUNT n)
+{
+  static const SUSCOUNT blocks[] =
+      {1, 7, 64, 71, 200, 447, 448, 449, 1000, 33};
+  su_iir_filt_t direct = su_iir_filt_INITIALIZER;
+  SUCOMPLEX x[1000], y[1000];
+  unsigned int i, j, p = 0;
+
+  REQUIRE(ols->ols_size > 0);
+  REQUIRE(su_iir_filt_init(&direct, 0, NULL, n, taps));
+
+  for (i = 0; i < sizeof(blocks) / sizeof(blocks[0]); ++i) {
+    for (j = 0; j < blocks[i]; ++j)
+      x[j] = test_signal(p++);
+
+    su_iir_filt_feed_bulk(ols, x, y, blocks[i]);
+
+    for (j = 0; j < blocks[i]; ++j)
+      REQUIRE(SU_C_ABS(su_iir_filt_feed(&direct, x[j]) - y[j]) < 1e-4);
+  }
+
+  su_iir_filt_finalize(ols);
+  su_iir_filt_finalize(&direct);
+}
+
+TEST_CASE("Test RRC overlap-save against direct form", "[IIR]")
+{
+  su_iir_filt_t ols = su_iir_filt_INITIALIZER;
+  SUFLOAT taps[65];
+
+  su_taps_rrc_init(taps, 8, .35, 65);
+  REQUIRE(su_iir_rrc_init(&ols, 65, 8, .35));
+
+  compare_ols_with_direct(&ols, taps, 65);
+}
+
+TEST_CASE("Test brickwall overlap-save against direct form", "[IIR]")
+{
+  su_iir_filt_t ols = su_iir_filt_INITIALIZER;
+  SUFLOAT taps[101];
+
+  su_taps_brickwall_lp_init(taps, .1, 101);
+  REQUIRE(su_iir_brickwall_lp_init(&ols, 101, .1));
+
+  compare_ols_with_direct(&ols, taps, 101);
+}
+
+/* Bulk filtering, in place or not, across block boundaries */
+static void
+compare_bulk_with_feed(su_iir_filt_t *bulk, su_iir_filt_t *ref, SUBOOL in_place)
+{
+  static const SUSCOUNT blocks[] = {1, 7, 511, 512, 513, 1500};
+  SUCOMPLEX x[1500], y[1500];
+  unsigned int i, j, p = 0;
+
+  for (i = 0; i < sizeof(blocks) / sizeof(blocks[0]); ++i) {
+    for (j = 0; j < blocks[i]; ++j)
+      x[j] = test_signal(p++);
+
+    if (in_place) {
+      memcpy(y, x, blocks[i] * sizeof(SUCOMPLEX));
+      su_iir_filt_feed_bulk(bulk, y, y, blocks[i]);
+    } else {
+      su_iir_filt_feed_bulk(bulk, x, y, blocks[i]);
+    }
+
+    for (j = 0; j < blocks[i]; ++j)
+      REQUIRE(SU_C_ABS(su_iir_filt_feed(ref, x[j]) - y[j]) < 1e-4);
+
+    REQUIRE(SU_C_ABS(su_iir_filt_get(bulk) - su_iir_filt_get(ref)) < 1e-4);
+  }
+
+  su_iir_filt_finalize(bulk);
+  su_iir_filt_finalize(ref);
+}
+
+/* Recursive filter in direct form */
+static void
+bwlp_direct_form_init(su_iir_filt_t *filt)
+{
+  direct_form_init(
+      filt,
+      5,
+      su_dcof_bwlp(4, .2),
+      su_ccof_bwlp(4),
+      su_sf_bwlp(4, .2));
+}
+
+TEST_CASE("Test bulk filtering of direct form filters", "[IIR]")
+{
+  su_iir_filt_t bulk = su_iir_filt_INITIALIZER;
+  su_iir_filt_t ref = su_iir_filt_INITIALIZER;
+  SUFLOAT taps[15];
+  unsigned int i;
+
+  su_taps_brickwall_lp_init(taps, .2, 15);
+
+  /* Out of place first, then in place */
+  for (i = 0; i < 2; ++i) {
+    bwlp_direct_form_init(&bulk);
+    bwlp_direct_form_init(&ref);
+    compare_bulk_with_feed(&bulk, &ref, i == 1);
+
+    REQUIRE(su_iir_filt_init(&bulk, 0, NULL, 15, taps));
+    REQUIRE(su_iir_filt_init(&ref, 0, NULL, 15, taps));
+    compare_bulk_with_feed(&bulk, &ref, i == 1);
+  }
+}
+
+TEST_CASE("Test bulk filtering of second order sections", "[IIR]")
+{
+  su_iir_filt_t bulk = su_iir_filt_INITIALIZER;
+  su_iir_filt_t ref = su_iir_filt_INITIALIZER;
+  unsigned int i;
+
+  for (i = 0; i < 2; ++i) {
+    REQUIRE(su_iir_bwbpf_init(&bulk, 3, .2, .4));
+    REQUIRE(su_iir_bwbpf_init(&ref, 3, .2, .4));
+    compare_bulk_with_feed(&bulk, &ref, i == 1);
+  }
+}
+
+/* Not a multiple of the chunk size of any thread count */
+#define PARALLEL_TEST_LEN (3 * SU_IIR_PARALLEL_MIN_CHUNK + 12345)
+
+/*
+ * Parallel filtering from a non-zero state, and the state it leaves. The
+ * last run is in place.
+ */
+static void
+compare_parallel_with_serial(su_iir_filt_t *parallel, su_iir_filt_t *serial)
+{
+  static const unsigned int threads[] = {2, 3, 4};
+  const unsigned int runs = sizeof(threads) / sizeof(threads[0]);
+  SUCOMPLEX *x, *y, *ref;
+  unsigned int i, j;
+
+  x = (SUCOMPLEX *)malloc(PARALLEL_TEST_LEN * sizeof(SUCOMPLEX));
+  y = (SUCOMPLEX *)malloc(PARALLEL_TEST_LEN * sizeof(SUCOMPLEX));
+  ref = (SUCOMPLEX *)malloc(PARALLEL_TEST_LEN * sizeof(SUCOMPLEX));
+  REQUIRE(x != NULL);
+  REQUIRE(y != NULL);
+  REQUIRE(ref != NULL);
+
+  for (i = 0; i < PARALLEL_TEST_LEN; ++i)
+    x[i] = test_signal(i);
+
+  for (i = 0; i < runs; ++i) {
+    su_iir_filt_feed_bulk(serial, x, ref, 100);
+    su_iir_filt_feed_bulk(parallel, x, y, 100);
+
+    su_iir_filt_feed_bulk(serial, x, ref, PARALLEL_TEST_LEN);
+
+    if (i + 1 == runs)
+      memcpy(y, x, PARALLEL_TEST_LEN * sizeof(SUCOMPLEX));
+
+    REQUIRE(su_iir_filt_feed_bulk_parallel(
+        parallel,
+        i + 1 == runs ? y : x,
+        y,
+        PARALLEL_TEST_LEN,
+        threads[i]));
+
+    for (j = 0; j < PARALLEL_TEST_LEN; ++j)
+      REQUIRE(SU_C_ABS(y[j] - ref[j]) < 1e-3);
+
+    for (j = 0; j < 100; ++j) {
+      y[j] = su_iir_filt_feed(parallel, x[j]);
+      REQUIRE(SU_C_ABS(y[j] - su_iir_filt_feed(serial, x[j])) < 1e-3);
+    }
+  }
+
+  free(x);
+  free(y);
+  free(ref);
+
+  su_iir_filt_finalize(parallel);
+  su_iir_filt_finalize(serial);
+}
+
+TEST_CASE("Test parallel filtering of second order sections", "[IIR]")
+{
+  su_iir_filt_t parallel = su_iir_filt_INITIALIZER;
+  su_iir_filt_t serial = su_iir_filt_INITIALIZER;
+
+  REQUIRE(su_iir_bwlpf_init(&parallel, 4, .05));
+  REQUIRE(su_iir_bwlpf_init(&serial, 4, .05));
+
+  compare_parallel_with_serial(&parallel, &serial);
+}
+
+TEST_CASE("Test parallel filtering of direct form filters", "[IIR]")
+{
+  su_iir_filt_t parallel = su_iir_filt_INITIALIZER;
+  su_iir_filt_t serial = su_iir_filt_INITIALIZER;
+
+  bwlp_direct_form_init(&parallel);
+  bwlp_direct_form_init(&serial);
+
+  compare_parallel_with_serial(&parallel, &serial);
+}
@@ -0,0 +1,8 @@
+/* SPDX-License-Identifier: GPL-3.0-only */
+
+/* Catch2 v3 provides its own main through Catch2WithMain */
+#ifdef CATCH2_V2
+#define CATCH_CONFIG_MAIN
+#endif
+
+#include "catch.hpp"
@@ -15,3 +15,118 @@ TEST_CASE("Test normalized frecuency scale", "[NCQO]")
   REQUIRE(SUFLOAT_EQUAL(su_ncqo_read_i(&ncqo), 1.0));
   REQUIRE(SUFLOAT_EQUAL(su_ncqo_read_i(&ncqo), -1.0));
 }
+
+TEST_CASE("Test LUT mode accuracy", "[NCQO]")
+{
+  su_ncqo_t nearest, interp;
+  SUCOMPLEX x;
+  double phi;
+  unsigned int i;
+
+  su_ncqo_init_lut(&nearest, 0.0123, SU_FALSE);
+  su_ncqo_init_lut(&interp, 0.0123, SU_TRUE);
+
+  REQUIRE(su_ncqo_get_mode(&nearest) == SU_NCQO_MODE_LUT);
+  REQUIRE(su_ncqo_get_mode(&interp) == SU_NCQO_MODE_LUT_INTERP);
+
+  for (i = 0; i < 1000; ++i) {
+    phi = M_PI * 0.0123 * i;
+    x = SUCOMPLEX(cos(phi), sin(phi));
+    REQUIRE(SU_C_ABS(su_ncqo_read(&nearest) - x) < 2e-3);
+    REQUIRE(SU_C_ABS(su_ncqo_read(&interp) - x) < 1e-5);
+  }
+}
+
+TEST_CASE("Test LUT mode phase accumulator", "[NCQO]")
+{
+  su_ncqo_t ncqo;
+  unsigned int i;
+
+  /* An eighth of a cycle per sample is exact in fixed point */
+  su_ncqo_init_lut(&ncqo, 0.25, SU_TRUE);
+
+  for (i = 0; i < 8000000; ++i)
+    su_ncqo_step(&ncqo);
+
+  REQUIRE(ncqo.acc == 0);
+  REQUIRE(SUFLOAT_EQUAL(su_ncqo_get_i(&ncqo), 1.0));
+  REQUIRE(SUFLOAT_EQUAL(su_ncqo_get_q(&ncqo), 0.0));
+}
+
+TEST_CASE("Test NCQO mode switch", "[NCQO]")
+{
+  su_ncqo_t ncqo;
+  SUFLOAT phi;
+  unsigned int i;
+
+  su_ncqo_init(&ncqo, 0.1);
+
+  for (i = 0; i < 7; ++i)
+    su_ncqo_step(&ncqo);
+
+  phi = su_ncqo_get_phase(&ncqo);
+
+  REQUIRE(su_ncqo_set_mode(&ncqo, SU_NCQO_MODE_LUT_INTERP));
+  REQUIRE(SU_ABS(su_ncqo_get_phase(&ncqo) - phi) < 1e-6);
+
+  su_ncqo_set_freq(&ncqo, 0.2);
+  su_ncqo_step(&ncqo);
+
+  REQUIRE(su_ncqo_set_mode(&ncqo, SU_NCQO_MODE_FLOAT));
+  REQUIRE(
+      SU_ABS(su_ncqo_get_phase(&ncqo) - su_phase_adjust(phi + .2 * PI))
+      < 1e-5);
+}
+
+TEST_CASE("Test bulk reads and mixing", "[NCQO]")
+{
+  su_ncqo_t ref, bulk, lut_ref, lut_bulk;
+  SUCOMPLEX out[1000], buf[1000];
+  unsigned int i;
+
+  su_ncqo_init(&ref, 0.0321);
+  su_ncqo_init(&bulk, 0.0321);
+  su_ncqo_init_lut(&lut_ref, 0.0321, SU_TRUE);
+  su_ncqo_init_lut(&lut_bulk, 0.0321, SU_TRUE);
+
+  /* Odd sizes, so that blocks are split */
+  su_ncqo_read_bulk(&bulk, out, 333);
+  su_ncqo_read_bulk(&bulk, out + 333, 667);
+
+  for (i = 0; i < 1000; ++i)
+    REQUIRE(SU_C_ABS(su_ncqo_read(&ref) - out[i]) < 1e-4);
+
+  REQUIRE(SU_ABS(su_ncqo_get_phase(&ref) - su_ncqo_get_phase(&bulk)) < 1e-4);
+
+  for (i = 0; i < 1000; ++i)
+    buf[i] = 1;
+
+  su_ncqo_mix_conj_bulk(&lut_bulk, buf, 1000);
+
+  for (i = 0; i < 1000; ++i)
+    REQUIRE(buf[i] == SU_C_CONJ(su_ncqo_read(&lut_ref)));
+
+  REQUIRE(lut_ref.acc == lut_bulk.acc);
+}
+
+TEST_CASE("Test fixed NCQO precalculated values", "[NCQO]")
+{
+  su_ncqo_t fixed, ref;
+  unsigned int i;
+
+  /* Only fixed oscillators carry precalculated values */
+  su_ncqo_init_lut(&ref, 0.0123, SU_TRUE);
+  REQUIRE(ref.precalc == NULL);
+  REQUIRE(sizeof(su_ncqo_t) < 128);
+
+  su_ncqo_init_fixed(&fixed, 0.0123);
+  su_ncqo_init(&ref, 0.0123);
+  REQUIRE(fixed.precalc != NULL);
+
+  /* Across several refills of the precalculated buffers */
+  for (i = 0; i < 3000; ++i)
+    REQUIRE(SU_C_ABS(su_ncqo_read(&fixed) - su_ncqo_read(&ref)) < 1e-4);
+
+  su_ncqo_finalize(&fixed);
+  REQUIRE(fixed.precalc == NULL);
+}
@@ -0,0 +1,118 @@
+/* SPDX-License-Identifier: GPL-3.0-only */
+
+#include "catch.hpp"
+
+#include <sigutils/pfbchan.h>
+
+#define PFBCHAN_TEST_CHANNELS 16
+#define PFBCHAN_TEST_BLOCK    64
+#define PFBCHAN_TEST_BLOCKS   8
+
+struct pfbchan_test_channel {
+  unsigned int blocks;
+  SUFLOAT power;     /* Mean power, after the first block */
+  SUFLOAT max_step;  /* Largest change between consecutive outputs */
+  SUCOMPLEX prev;
+};
+
+static SUBOOL
+pfbchan_test_on_data(
+    const su_pfbchan_channel_t *channel,
+    void *privdata,
+    const SUCOMPLEX *data,
+    SUSCOUNT size)
+{
+  struct pfbchan_test_channel *state =
+      (struct pfbchan_test_channel *)privdata;
+  SUSCOUNT i;
+
+  /* The first block contains the transient of the prototype filter */
+  if (state->blocks++ > 0)
+    for (i = 0; i < size; ++i) {
+      state->power += SU_C_REAL(data[i] * SU_C_CONJ(data[i]));
+      state->max_step =
+          SU_MAX(state->max_step, SU_C_ABS(data[i] - state->prev));
+      state->prev = data[i];
+    }
+  else
+    state->prev = data[size - 1];
+
+  return SU_TRUE;
+}
+
+/* A tone at the center of channel k must appear on channel k only */
+static void
+check_pfbchan_tone(SUBOOL oversample, unsigned int k)
+{
+  struct sigutils_pfbchan_params params = sigutils_pfbchan_params_INITIALIZER;
+  struct sigutils_pfbchan_channel_params ch_params =
+      sigutils_pfbchan_channel_params_INITIALIZER;
+  struct pfbchan_test_channel state[PFBCHAN_TEST_CHANNELS] = {};
+  su_pfbchan_t *pfb = NULL;
+  SUCOMPLEX *x = NULL;
+  SUSCOUNT len, outputs;
+  SUFLOAT omega;
+  unsigned int i;
+
+  params.channels = PFBCHAN_TEST_CHANNELS;
+  params.block_size = PFBCHAN_TEST_BLOCK;
+  params.oversample = oversample;
+
+  REQUIRE((pfb = su_pfbchan_new(&params)) != NULL);
+
+  ch_params.on_data = pfbchan_test_on_data;
+
+  for (i = 0; i < PFBCHAN_TEST_CHANNELS; ++i) {
+    ch_params.index = i;
+    ch_params.privdata = state + i;
+    REQUIRE(su_pfbchan_open_channel(pfb, &ch_params) != NULL);
+  }
+
+  len = PFBCHAN_TEST_BLOCKS * PFBCHAN_TEST_BLOCK
+        * su_pfbchan_get_decimation(pfb);
+  x = (SUCOMPLEX *)malloc(len * sizeof(SUCOMPLEX));
+  REQUIRE(x != NULL);
+
+  omega = su_pfbchan_get_channel_f0(pfb, k);
+  REQUIRE(su_pfbchan_get_channel_index(pfb, omega) == k);
+
+  for (i = 0; i < len; ++i)
+    x[i] = SUCOMPLEX(cos((double)omega * i), sin((double)omega * i));
+
+  /* Odd sizes, so that outputs are split across calls */
+  for (i = 0; i < len; i += 333)
+    REQUIRE(su_pfbchan_feed_bulk(pfb, x + i, SU_MIN(333, len - i)));
+
+  outputs = (PFBCHAN_TEST_BLOCKS - 1) * PFBCHAN_TEST_BLOCK;
+
+  for (i = 0; i < PFBCHAN_TEST_CHANNELS; ++i) {
+    REQUIRE(state[i].blocks == PFBCHAN_TEST_BLOCKS);
+
+    if (i == k) {
+      /* Unity gain, and a constant phasor at the channel output */
+      REQUIRE(SU_ABS(SU_POWER_DB(state[i].power / outputs)) < .5);
+      REQUIRE(state[i].max_step < 1e-3);
+    } else {
+      REQUIRE(SU_POWER_DB(state[i].power / outputs) < -50);
+    }
+  }
+
+  free(x);
+  su_pfbchan_destroy(pfb);
+}
+
+TEST_CASE("Test critically sampled filter bank", "[PFBChan]")
+{
+  unsigned int k;
+
+  for (k = 0; k < PFBCHAN_TEST_CHANNELS; k += 3)
+    check_pfbchan_tone(SU_FALSE, k);
+}
+
+TEST_CASE("Test oversampled filter bank", "[PFBChan]")
+{
+  unsigned int k;
+
+  for (k = 0; k < PFBCHAN_TEST_CHANNELS; k += 3)
+    check_pfbchan_tone(SU_TRUE, k);
+}
@@ -0,0 +1,622 @@
+/* SPDX-License-Identifier: GPL-3.0-only */
+
+#include "catch.hpp"
+
+#include <string.h>
+#include <unistd.h>
+
+#include <sigutils/sigutils.h>
+#include <sigutils/specttuner.h>
+
+#define SPECTTUNER_TEST_WINDOW 512
+#define SPECTTUNER_TEST_LEN    (20 * SPECTTUNER_TEST_WINDOW + 123)
+
+enum specttuner_test_feed {
+  SPECTTUNER_TEST_FEED_BULK,
+  SPECTTUNER_TEST_FEED_ACQUIRE,
+  SPECTTUNER_TEST_FEED_SAMPLE
+};
+
+/* Channels on both halves of the spectrum, precise and not */
+static const struct {
+  SUFLOAT f0;
+  SUFLOAT bw;
+  SUBOOL precise;
+} specttuner_test_channels[] = {
+    {.3, .1, SU_FALSE},
+    {1.2, .25, SU_TRUE},
+    {3.5, .2, SU_FALSE},
+    {5., .4, SU_TRUE},
+    {2 * M_PI - .7, .05, SU_TRUE},
+};
+
+#define SPECTTUNER_TEST_CHANNELS \
+  (sizeof(specttuner_test_channels) / sizeof(specttuner_test_channels[0]))
+
+struct specttuner_test_output {
+  SUCOMPLEX *data;
+  SUSCOUNT count;
+};
+
+/* Called from the worker threads too: no assertions here */
+static SUBOOL
+specttuner_test_on_data(
+    const su_specttuner_channel_t *channel,
+    void *privdata,
+    const SUCOMPLEX *data,
+    SUSCOUNT size)
+{
+  struct specttuner_test_output *output =
+      (struct specttuner_test_output *)privdata;
+
+  if (output->count + size > SPECTTUNER_TEST_LEN)
+    return SU_FALSE;
+
+  memcpy(output->data + output->count, data, size * sizeof(SUCOMPLEX));
+  output->count += size;
+
+  return SU_TRUE;
+}
+
+/* Real-valued, so that it can be fed in both modes */
+static SUFLOAT
+specttuner_test_signal(unsigned int i)
+{
+  return cos(.31 * i) + .5 * cos(1.23 * i + .4) + .25 * cos(2.9 * i)
+         + .1 * sin(.017 * i * i);
+}
+
+static void
+specttuner_test_outputs_init(struct specttuner_test_output *outputs)
+{
+  unsigned int i;
+
+  for (i = 0; i < SPECTTUNER_TEST_CHANNELS; ++i) {
+    outputs[i].data =
+        (SUCOMPLEX *)malloc(SPECTTUNER_TEST_LEN * sizeof(SUCOMPLEX));
+    outputs[i].count = 0;
+    REQUIRE(outputs[i].data != NULL);
+  }
+}
+
+static void
+specttuner_test_outputs_finalize(struct specttuner_test_output *outputs)
+{
+  unsigned int i;
+
+  for (i = 0; i < SPECTTUNER_TEST_CHANNELS; ++i)
+    free(outputs[i].data);
+}
+
+static void
+specttuner_test_channel_params(
+    struct sigutils_specttuner_channel_params *params,
+    unsigned int i,
+    struct specttuner_test_output *outputs)
+{
+  struct sigutils_specttuner_channel_params initial =
+      sigutils_specttuner_channel_params_INITIALIZER;
+
+  *params = initial;
+  params->f0 = specttuner_test_channels[i].f0;
+  params->bw = specttuner_test_channels[i].bw;
+  params->precise = specttuner_test_channels[i].precise;
+  params->privdata = outputs + i;
+  params->on_data = specttuner_test_on_data;
+}
+
+static su_specttuner_t *
+specttuner_test_new(
+    SUBOOL real_input,
+    unsigned int overlap,
+    unsigned int threads,
+    SUBOOL background)
+{
+  struct sigutils_specttuner_params params =
+      sigutils_specttuner_params_INITIALIZER;
+  su_specttuner_t *st;
+
+  params.window_size = SPECTTUNER_TEST_WINDOW;
+  params.real_input = real_input;
+  params.overlap = overlap;
+  params.num_threads = threads;
+  params.background_planning = background;
+
+  REQUIRE((st = su_specttuner_new(&params)) != NULL);
+
+  return st;
+}
+
+static void
+specttuner_test_open(
+    su_specttuner_t *st,
+    struct specttuner_test_output *outputs)
+{
+  struct sigutils_specttuner_channel_params params;
+  unsigned int i;
+
+  for (i = 0; i < SPECTTUNER_TEST_CHANNELS; ++i) {
+    specttuner_test_channel_params(&params, i, outputs);
+    REQUIRE(su_specttuner_open_channel(st, &params) != NULL);
+  }
+}
+
+/* Feeds samples [from, to) of the test signal */
+static void
+specttuner_test_feed(
+    su_specttuner_t *st,
+    enum specttuner_test_feed mode,
+    unsigned int from,
+    unsigned int to)
+{
+  SUBOOL real_input = st->params.real_input;
+  SUCOMPLEX x[333];
+  SUFLOAT xr[333];
+  SUCOMPLEX *span;
+  SUFLOAT *span_real;
+  SUSCOUNT avail, n;
+  unsigned int i, j;
+
+  for (i = from; i < to; i += n) {
+    /* Odd sizes, so that windows are split across calls */
+    n = SU_MIN(333, to - i);
+
+    switch (mode) {
+      case SPECTTUNER_TEST_FEED_BULK:
+        for (j = 0; j < n; ++j)
+          x[j] = xr[j] = specttuner_test_signal(i + j);
+
+        if (real_input)
+          REQUIRE(su_specttuner_feed_bulk_real(st, xr, n));
+        else
+          REQUIRE(su_specttuner_feed_bulk(st, x, n));
+        break;
+
+      case SPECTTUNER_TEST_FEED_ACQUIRE:
+        if (real_input) {
+          span_real = su_specttuner_acquire_real(st, &avail);
+          REQUIRE(span_real != NULL);
+          n = SU_MIN(n, avail);
+          for (j = 0; j < n; ++j)
+            span_real[j] = specttuner_test_signal(i + j);
+        } else {
+          span = su_specttuner_acquire(st, &avail);
+          REQUIRE(span != NULL);
+          n = SU_MIN(n, avail);
+          for (j = 0; j < n; ++j)
+            span[j] = specttuner_test_signal(i + j);
+        }
+
+        REQUIRE(su_specttuner_commit(st, n));
+        break;
+
+      case SPECTTUNER_TEST_FEED_SAMPLE:
+        for (j = 0; j < n; ++j) {
+          if (real_input)
+            (void)su_specttuner_feed_sample_real(
+                st,
+                specttuner_test_signal(i + j));
+          else
+            (void)su_specttuner_feed_sample(st, specttuner_test_signal(i + j));
+
+          REQUIRE(su_specttuner_feed_all_channels(st));
+        }
+        break;
+    }
+  }
+}
+
+static void
+specttuner_test_compare_channel(
+    const struct specttuner_test_output *output,
+    const struct specttuner_test_output *ref,
+    SUFLOAT tol)
+{
+  SUSCOUNT j;
+
+  REQUIRE(ref->count > 0);
+  REQUIRE(output->count == ref->count);
+
+  for (j = 0; j < ref->count; ++j)
+    if (tol > 0)
+      REQUIRE(SU_C_ABS(output->data[j] - ref->data[j]) < tol);
+    else
+      REQUIRE(output->data[j] == ref->data[j]);
+}
+
+static void
+specttuner_test_compare(
+    const struct specttuner_test_output *outputs,
+    const struct specttuner_test_output *ref,
+    SUFLOAT tol)
+{
+  unsigned int i;
+
+  for (i = 0; i < SPECTTUNER_TEST_CHANNELS; ++i)
+    specttuner_test_compare_channel(outputs + i, ref + i, tol);
+}
+
+/* Output of a tuner fed with the whole test signal */
+static void
+specttuner_test_run(
+    struct specttuner_test_output *outputs,
+    SUBOOL real_input,
+    unsigned int overlap,
+    enum specttuner_test_feed mode,
+    unsigned int threads)
+{
+  su_specttuner_t *st =
+      specttuner_test_new(real_input, overlap, threads, SU_FALSE);
+
+  specttuner_test_outputs_init(outputs);
+  specttuner_test_open(st, outputs);
+  specttuner_test_feed(st, mode, 0, SPECTTUNER_TEST_LEN);
+
+  su_specttuner_destroy(st);
+}
+
+TEST_CASE("Test real input against complex input", "[Specttuner]")
+{
+  static const unsigned int overlaps[] = {2, 4};
+  static const enum specttuner_test_feed modes[] = {
+      SPECTTUNER_TEST_FEED_BULK,
+      SPECTTUNER_TEST_FEED_ACQUIRE,
+      SPECTTUNER_TEST_FEED_SAMPLE};
+  struct specttuner_test_output ref[SPECTTUNER_TEST_CHANNELS];
+  struct specttuner_test_output outputs[SPECTTUNER_TEST_CHANNELS];
+  unsigned int i, j;
+
+  for (i = 0; i < sizeof(overlaps) / sizeof(overlaps[0]); ++i) {
+    specttuner_test_run(
+        ref,
+        SU_FALSE,
+        overlaps[i],
+        SPECTTUNER_TEST_FEED_BULK,
+        0);
+
+    for (j = 0; j < sizeof(modes) / sizeof(modes[0]); ++j) {
+      /* Complex input, fed in other ways */
+      specttuner_test_run(outputs, SU_FALSE, overlaps[i], modes[j], 0);
+      specttuner_test_compare(outputs, ref, 0);
+      specttuner_test_outputs_finalize(outputs);
+
+      /* Same signal, as real input (r2c and c2c FFTs round differently) */
+      specttuner_test_run(outputs, SU_TRUE, overlaps[i], modes[j], 0);
+      specttuner_test_compare(outputs, ref, 1e-4);
+      specttuner_test_outputs_finalize(outputs);
+    }
+
+    specttuner_test_outputs_finalize(ref);
+  }
+}
+
+TEST_CASE("Test worker pool against serial feeding", "[Specttuner]")
+{
+  static const unsigned int threads[] = {2, 3, 5};
+  struct specttuner_test_output ref[SPECTTUNER_TEST_CHANNELS];
+  struct specttuner_test_output outputs[SPECTTUNER_TEST_CHANNELS];
+  unsigned int i, real;
+
+  for (real = 0; real < 2; ++real) {
+    specttuner_test_run(ref, real, 2, SPECTTUNER_TEST_FEED_BULK, 0);
+
+    /* Same computations, whatever the thread that runs them */
+    for (i = 0; i < sizeof(threads) / sizeof(threads[0]); ++i) {
+      specttuner_test_run(
+          outputs,
+          real,
+          2,
+          SPECTTUNER_TEST_FEED_BULK,
+          threads[i]);
+      specttuner_test_compare(outputs, ref, 0);
+      specttuner_test_outputs_finalize(outputs);
+    }
+
+    specttuner_test_outputs_finalize(ref);
+  }
+}
+
+#define SPECTTUNER_TEST_GROUP 7
+
+/* Same size channels, the last one in the frequency domain */
+static void
+specttuner_test_group_params(
+    struct sigutils_specttuner_channel_params *params,
+    unsigned int i,
+    struct specttuner_test_output *output)
+{
+  struct sigutils_specttuner_channel_params initial =
+      sigutils_specttuner_channel_params_INITIALIZER;
+
+  *params = initial;
+  params->f0 = .3 + .85 * i;
+  params->bw = .2;
+  params->precise = i & 1;
+  params->privdata = output;
+  params->on_data = specttuner_test_on_data;
+
+  if (i + 1 == SPECTTUNER_TEST_GROUP)
+    params->domain = SU_SPECTTUNER_CHANNEL_FREQUENCY_DOMAIN;
+}
+
+TEST_CASE("Test batched channels against single channels", "[Specttuner]")
+{
+  struct sigutils_specttuner_channel_params params;
+  struct specttuner_test_output outputs[SPECTTUNER_TEST_GROUP];
+  struct specttuner_test_output ref;
+  su_specttuner_channel_t *channels[SPECTTUNER_TEST_GROUP];
+  su_specttuner_t *st;
+  unsigned int i, half = SPECTTUNER_TEST_LEN / 2;
+
+  /* All channels in a single group, two of them closed halfway */
+  st = specttuner_test_new(SU_FALSE, 2, 0, SU_FALSE);
+
+  for (i = 0; i < SPECTTUNER_TEST_GROUP; ++i) {
+    outputs[i].data =
+        (SUCOMPLEX *)malloc(SPECTTUNER_TEST_LEN * sizeof(SUCOMPLEX));
+    outputs[i].count = 0;
+    REQUIRE(outputs[i].data != NULL);
+
+    specttuner_test_group_params(&params, i, outputs + i);
+    REQUIRE((channels[i] = su_specttuner_open_channel(st, &params)) != NULL);
+  }
+
+  REQUIRE(channels[0]->group == channels[SPECTTUNER_TEST_GROUP - 1]->group);
+
+  specttuner_test_feed(st, SPECTTUNER_TEST_FEED_BULK, 0, half);
+  REQUIRE(su_specttuner_close_channel(st, channels[1]));
+  REQUIRE(su_specttuner_close_channel(st, channels[4]));
+  specttuner_test_feed(
+      st,
+      SPECTTUNER_TEST_FEED_BULK,
+      half,
+      SPECTTUNER_TEST_LEN);
+
+  su_specttuner_destroy(st);
+
+  /* Every channel on its own, with single transforms */
+  ref.data = (SUCOMPLEX *)malloc(SPECTTUNER_TEST_LEN * sizeof(SUCOMPLEX));
+  REQUIRE(ref.data != NULL);
+
+  for (i = 0; i < SPECTTUNER_TEST_GROUP; ++i) {
+    ref.count = 0;
+
+    st = specttuner_test_new(SU_FALSE, 2, 0, SU_FALSE);
+    specttuner_test_group_params(&params, i, &ref);
+    REQUIRE(su_specttuner_open_channel(st, &params) != NULL);
+    specttuner_test_feed(
+        st,
+        SPECTTUNER_TEST_FEED_BULK,
+        0,
+        i == 1 || i == 4 ? half : SPECTTUNER_TEST_LEN);
+    su_specttuner_destroy(st);
+
+    /* Batched and single transforms may round differently */
+    specttuner_test_compare_channel(outputs + i, &ref, 1e-5);
+    free(outputs[i].data);
+  }
+
+  free(ref.data);
+}
+
+/* Channel commands, at sample positions unrelated to the windows */
+enum specttuner_test_command {
+  SPECTTUNER_TEST_OPEN,
+  SPECTTUNER_TEST_CLOSE,
+  SPECTTUNER_TEST_SET_FREQ,
+  SPECTTUNER_TEST_SET_DELTA_F
+};
+
+static const struct {
+  unsigned int at;
+  enum specttuner_test_command command;
+  unsigned int channel;
+  SUFLOAT value;
+} specttuner_test_schedule[] = {
+    {0, SPECTTUNER_TEST_OPEN, 0, 0},
+    {0, SPECTTUNER_TEST_OPEN, 1, 0},
+    {1500, SPECTTUNER_TEST_OPEN, 2, 0},
+    {1500, SPECTTUNER_TEST_OPEN, 3, 0},
+    {3001, SPECTTUNER_TEST_SET_FREQ, 0, 1.25},
+    {3001, SPECTTUNER_TEST_SET_DELTA_F, 1, .01},
+    {5000, SPECTTUNER_TEST_CLOSE, 1, 0},
+    {6789, SPECTTUNER_TEST_OPEN, 4, 0},
+    {6789, SPECTTUNER_TEST_SET_FREQ, 3, 4.5},
+    {8200, SPECTTUNER_TEST_CLOSE, 2, 0},
+};
+
+#define SPECTTUNER_TEST_SCHEDULE                \
+  (sizeof(specttuner_test_schedule)             \
+   / sizeof(specttuner_test_schedule[0]))
+
+/* Plans requested by the tuner that were not swapped in yet */
+static unsigned int
+specttuner_test_pending_plans(const su_specttuner_t *st)
+{
+  unsigned int i, pending = 0;
+
+  for (i = 0; i < st->group_count; ++i)
+    if (st->group_list[i] != NULL)
+      pending += __builtin_popcount(
+          st->group_list[i]->requested & ~st->group_list[i]->measured);
+
+  return pending;
+}
+
+/* Plans swapped in by the tuner */
+static unsigned int
+specttuner_test_measured_plans(const su_specttuner_t *st)
+{
+  unsigned int i, measured = 0;
+
+  for (i = 0; i < st->group_count; ++i)
+    if (st->group_list[i] != NULL)
+      measured += __builtin_popcount(st->group_list[i]->measured);
+
+  return measured;
+}
+
+/*
+ * Waits until the planner has posted back every pending plan, so that
+ * they are all swapped in at the next window. Only the feeding thread
+ * pops the command stack, so the posted plans stay there meanwhile.
+ */
+static void
+specttuner_test_wait_plans(su_specttuner_t *st)
+{
+  const su_specttuner_command_t *cmd;
+  unsigned int posted, tries;
+
+  for (tries = 0; tries < 10000; ++tries) {
+    posted = 0;
+    cmd    = __atomic_load_n(&st->commands, __ATOMIC_ACQUIRE);
+
+    for (; cmd != NULL; cmd = cmd->next)
+      if (cmd->type == SU_SPECTTUNER_COMMAND_SWAP_PLAN)
+        ++posted;
+
+    if (posted >= specttuner_test_pending_plans(st))
+      return;
+
+    usleep(1000);
+  }
+
+  FAIL("Planner did not provide the requested plans");
+}
+
+static void
+specttuner_test_run_schedule(
+    struct specttuner_test_output *outputs,
+    SUBOOL async,
+    unsigned int threads,
+    SUBOOL background)
+{
+  struct sigutils_specttuner_channel_params params;
+  su_specttuner_channel_t *channels[SPECTTUNER_TEST_CHANNELS];
+  su_specttuner_channel_t *channel;
+  su_specttuner_t *st =
+      specttuner_test_new(SU_FALSE, 2, threads, background);
+  unsigned int i, p = 0;
+
+  REQUIRE((st->planner != NULL) == background);
+
+  specttuner_test_outputs_init(outputs);
+
+  for (i = 0; i < SPECTTUNER_TEST_SCHEDULE; ++i) {
+    specttuner_test_feed(
+        st,
+        SPECTTUNER_TEST_FEED_BULK,
+        p,
+        specttuner_test_schedule[i].at);
+    p = specttuner_test_schedule[i].at;
+
+    /* Measured plans take over at a known window */
+    if (background)
+      specttuner_test_wait_plans(st);
+
+    channel = channels[specttuner_test_schedule[i].channel];
+
+    switch (specttuner_test_schedule[i].command) {
+      case SPECTTUNER_TEST_OPEN:
+        specttuner_test_channel_params(
+            &params,
+            specttuner_test_schedule[i].channel,
+            outputs);
+
+        channel = async ? su_specttuner_open_channel_async(st, &params)
+                        : su_specttuner_open_channel(st, &params);
+        REQUIRE(channel != NULL);
+
+        channels[specttuner_test_schedule[i].channel] = channel;
+        break;
+
+      case SPECTTUNER_TEST_CLOSE:
+        if (async)
+          REQUIRE(su_specttuner_close_channel_async(st, channel));
+        else
+          REQUIRE(su_specttuner_close_channel(st, channel));
+        break;
+
+      case SPECTTUNER_TEST_SET_FREQ:
+        if (async)
+          REQUIRE(su_specttuner_set_channel_freq_async(
+              st,
+              channel,
+              specttuner_test_schedule[i].value));
+        else
+          su_specttuner_set_channel_freq(
+              st,
+              channel,
+              specttuner_test_schedule[i].value);
+        break;
+
+      case SPECTTUNER_TEST_SET_DELTA_F:
+        if (async)
+          REQUIRE(su_specttuner_set_channel_delta_f_async(
+              st,
+              channel,
+              specttuner_test_schedule[i].value));
+        else
+          su_specttuner_set_channel_delta_f(
+              st,
+              channel,
+              specttuner_test_schedule[i].value);
+        break;
+    }
+  }
+
+  specttuner_test_feed(st, SPECTTUNER_TEST_FEED_BULK, p, SPECTTUNER_TEST_LEN);
+
+  if (background)
+    REQUIRE(specttuner_test_measured_plans(st) > 0);
+
+  su_specttuner_destroy(st);
+}
+
+TEST_CASE("Test asynchronous channel commands", "[Specttuner]")
+{
+  struct specttuner_test_output ref[SPECTTUNER_TEST_CHANNELS];
+  struct specttuner_test_output outputs[SPECTTUNER_TEST_CHANNELS];
+
+  specttuner_test_run_schedule(ref, SU_FALSE, 0, SU_FALSE);
+
+  /* Commands take effect at the same window as their direct counterparts */
+  specttuner_test_run_schedule(outputs, SU_TRUE, 0, SU_FALSE);
+  specttuner_test_compare(outputs, ref, 0);
+  specttuner_test_outputs_finalize(outputs);
+
+  specttuner_test_run_schedule(outputs, SU_TRUE, 3, SU_FALSE);
+  specttuner_test_compare(outputs, ref, 0);
+  specttuner_test_outputs_finalize(outputs);
+
+  specttuner_test_outputs_finalize(ref);
+}
+
+TEST_CASE("Test background planning", "[Specttuner]")
+{
+  struct specttuner_test_output ref[SPECTTUNER_TEST_CHANNELS];
+  struct specttuner_test_output outputs[SPECTTUNER_TEST_CHANNELS];
+
+  /* The planner only exists if plans are measured */
+  REQUIRE(su_lib_set_wisdom_file("sigutils_test.wisdom"));
+  REQUIRE(su_lib_set_wisdom_enabled(SU_TRUE));
+
+  specttuner_test_run_schedule(ref, SU_FALSE, 0, SU_FALSE);
+
+  /*
+   * Whenever the measured plans make it to the tuner, the output must
+   * not change (beyond the rounding of the different plans).
+   */
+  specttuner_test_run_schedule(outputs, SU_FALSE, 0, SU_TRUE);
+  specttuner_test_compare(outputs, ref, 1e-4);
+  specttuner_test_outputs_finalize(outputs);
+
+  specttuner_test_run_schedule(outputs, SU_TRUE, 3, SU_TRUE);
+  specttuner_test_compare(outputs, ref, 1e-4);
+  specttuner_test_outputs_finalize(outputs);
+
+  specttuner_test_outputs_finalize(ref);
+
+  REQUIRE(su_lib_set_wisdom_enabled(SU_FALSE));
+  REQUIRE(su_lib_set_wisdom_file(NULL));
+}